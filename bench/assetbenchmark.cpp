@@ -0,0 +1,497 @@
+#include "assetbenchmark.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+#include <Tempest/MemReader>
+#include <Tempest/Pixmap>
+
+#include <zenkit/Vfs.hh>
+#include <zenkit/MultiResolutionMesh.hh>
+#include <zenkit/ModelMesh.hh>
+#include <zenkit/ModelHierarchy.hh>
+#include <zenkit/ModelScript.hh>
+#include <zenkit/Texture.hh>
+#include <zenkit/World.hh>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <tuple>
+
+#include "bink/video.h"
+#include "dmusic/mixer.h"
+#include "graphics/mesh/submesh/packedmesh.h"
+#include "graphics/mesh/animation.h"
+#include "graphics/mesh/attachbinder.h"
+#include "graphics/mesh/protomesh.h"
+#include "graphics/mesh/skeleton.h"
+#include "physics/collisionworld.h"
+#include "physics/physicvbo.h"
+#include "utils/fileext.h"
+#include "utils/string_frm.h"
+#include "commandline.h"
+#include "gothic.h"
+#include "resources.h"
+
+using namespace Tempest;
+
+namespace {
+
+// per-thread: loader, sound and worker threads must not leak into numbers of benchmark thread
+thread_local bool     countAllocs = false;
+thread_local uint64_t allocCount  = 0;
+
+struct AllocScope final {
+  AllocScope()  { allocCount = 0; countAllocs = true;  }
+  ~AllocScope() { countAllocs = false; }
+  uint64_t count() const { return allocCount; }
+  };
+
+template<class F>
+double timeMs(F&& fn) {
+  const auto begin = std::chrono::steady_clock::now();
+  fn();
+  const auto end   = std::chrono::steady_clock::now();
+  return std::chrono::duration<double,std::milli>(end-begin).count();
+  }
+
+uint64_t fileSize(const zenkit::VfsNode& node) {
+  auto rd = node.open_read();
+  rd->seek(0, zenkit::Whence::END);
+  return uint64_t(rd->tell());
+  }
+
+struct BinkInput : Bink::Video::Input {
+  BinkInput(zenkit::Read& fin):fin(fin) {}
+
+  void read(void *dest, size_t count) override {
+    if(fin.read(dest,count)!=count)
+      throw std::runtime_error("i/o error");
+    }
+  void skip(size_t count) override {
+    fin.seek(ptrdiff_t(count), zenkit::Whence::CUR);
+    }
+  void seek(size_t pos) override {
+    fin.seek(ptrdiff_t(pos), zenkit::Whence::BEG);
+    }
+
+  zenkit::Read& fin;
+  };
+
+}
+
+// Allocation counting: global operator new is replaced for the whole 'bench' executable
+void* operator new(size_t size) {
+  if(countAllocs)
+    ++allocCount;
+  if(size==0)
+    size = 1;
+  while(true) {
+    if(void* p = std::malloc(size))
+      return p;
+    auto handler = std::get_new_handler();
+    if(handler==nullptr)
+      throw std::bad_alloc();
+    handler();
+    }
+  }
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+  }
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+  }
+
+AssetBenchmark::AssetBenchmark(const CommandLine& cmd)
+  :output(cmd.assetBenchmarkOutput()) {
+  }
+
+const char* AssetBenchmark::kindName(Kind k) {
+  switch(k) {
+    case K_Mesh:      return "mesh";
+    case K_Model:     return "model";
+    case K_World:     return "world";
+    case K_Animation: return "animation";
+    case K_Skeleton:  return "skeleton";
+    case K_Texture:   return "texture";
+    case K_Video:     return "video";
+    case K_Music:     return "music";
+    case K_Count:     break;
+    }
+  return "";
+  }
+
+int AssetBenchmark::exec() {
+  collect(Resources::vdfsIndex().root());
+  collectMusic();
+  std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b){
+    return std::tie(a.kind,a.name) < std::tie(b.kind,b.name);
+    });
+
+  string_frm info("Asset benchmark: ", assets.size(), " assets");
+  Log::i(info.c_str());
+
+  std::vector<Sample> samples;
+  samples.reserve(assets.size());
+  for(auto& a:assets)
+    samples.push_back(run(a));
+
+  for(uint8_t k=0; k<K_Count; ++k) {
+    size_t   count = 0, failed = 0;
+    double   ms    = 0;
+    uint64_t alloc = 0;
+    for(auto& s:samples) {
+      if(s.kind!=k)
+        continue;
+      ++count;
+      failed += s.failed ? 1 : 0;
+      ms     += s.loadMs + s.buildMs + s.bindMs;
+      alloc  += s.allocs;
+      }
+    if(count==0)
+      continue;
+    const double aps = ms>0 ? double(count)*1000.0/ms : 0.0;
+    string_frm sub("  ", kindName(Kind(k)), ": count = ", count, " failed = ", failed,
+                   " time = ", ms, " ms assets/sec = ", aps, " allocs = ", size_t(alloc));
+    Log::i(sub.c_str());
+    }
+
+  if(!output.empty() && !writeReport(samples))
+    return -1;
+  return 0;
+  }
+
+void AssetBenchmark::collect(const zenkit::VfsNode& node) {
+  if(node.type()!=zenkit::VfsNodeType::FILE) {
+    for(auto& i:node.children())
+      collect(i);
+    return;
+    }
+
+  auto name = std::string(node.name());
+  for(auto& c:name)
+    c = char(std::toupper(c));
+
+  Kind kind = K_Count;
+  if(FileExt::hasExt(name,"MRM"))
+    kind = K_Mesh;
+  else if(FileExt::hasExt(name,"MDM"))
+    kind = K_Model;
+  else if(FileExt::hasExt(name,"ZEN"))
+    kind = K_World;
+  else if(FileExt::hasExt(name,"MSB") || FileExt::hasExt(name,"MDS"))
+    kind = K_Animation;
+  else if(FileExt::hasExt(name,"MDH"))
+    kind = K_Skeleton;
+  else if(FileExt::hasExt(name,"TEX"))
+    kind = K_Texture;
+  else if(FileExt::hasExt(name,"BIK"))
+    kind = K_Video;
+  if(kind==K_Count)
+    return;
+
+  Asset a;
+  a.kind = kind;
+  a.name = std::move(name);
+  a.node = &node;
+  assets.push_back(std::move(a));
+  }
+
+void AssetBenchmark::collectMusic() {
+  const std::u16string dirs[] = {
+    Gothic::nestedPath({u"_work",u"Data",u"Music",u"newworld"},  Dir::FT_Dir),
+    Gothic::nestedPath({u"_work",u"Data",u"Music",u"AddonWorld"},Dir::FT_Dir),
+    Gothic::nestedPath({u"_work",u"Data",u"Music",u"dungeon"},   Dir::FT_Dir),
+    Gothic::nestedPath({u"_work",u"Data",u"Music",u"menu_men"},  Dir::FT_Dir),
+    Gothic::nestedPath({u"_work",u"Data",u"Music",u"orchestra"}, Dir::FT_Dir),
+    };
+  for(auto& d:dirs) {
+    std::error_code ec;
+    if(d.empty() || !std::filesystem::is_directory(d,ec))
+      continue;
+    for(auto& e:std::filesystem::directory_iterator(d,ec)) {
+      auto name = e.path().filename().string();
+      if(!e.is_regular_file(ec) || !FileExt::hasExt(name,"SGT"))
+        continue;
+      Asset a;
+      a.kind = K_Music;
+      a.name = std::move(name);
+      a.path = e.path().u16string();
+      assets.push_back(std::move(a));
+      }
+    }
+  }
+
+AssetBenchmark::Sample AssetBenchmark::run(const Asset& a) {
+  Sample s;
+  s.kind = a.kind;
+  s.name = a.name;
+  try {
+    AllocScope alloc;
+    switch(a.kind) {
+      case K_Mesh:      benchMesh     (a,s); break;
+      case K_Model:     benchModel    (a,s); break;
+      case K_World:     benchWorld    (a,s); break;
+      case K_Animation: benchAnimation(a,s); break;
+      case K_Skeleton:  benchSkeleton (a,s); break;
+      case K_Texture:   benchTexture  (a,s); break;
+      case K_Video:     benchVideo    (a,s); break;
+      case K_Music:     benchMusic    (a,s); break;
+      case K_Count:     break;
+      }
+    s.allocs = alloc.count();
+    }
+  catch(const std::exception& e) {
+    Log::e("Asset benchmark: \"", a.name, "\" - ", e.what());
+    s.failed = true;
+    }
+  catch(...) {
+    Log::e("Asset benchmark: \"", a.name, "\" - failed");
+    s.failed = true;
+    }
+
+  if(a.node!=nullptr)
+    s.bytes = fileSize(*a.node);
+  else if(!a.path.empty()) {
+    std::error_code ec;
+    auto sz = std::filesystem::file_size(a.path,ec);
+    s.bytes = ec ? 0 : uint64_t(sz);
+    }
+  return s;
+  }
+
+void AssetBenchmark::benchMesh(const Asset& a, Sample& s) {
+  zenkit::MultiResolutionMesh zmsh;
+  s.loadMs = timeMs([&]() {
+    auto reader = a.node->open_read();
+    zmsh.load(reader.get());
+    });
+  s.buildMs = timeMs([&]() {
+    PackedMesh visual(zmsh,PackedMesh::PK_Visual);
+    PackedMesh physic(zmsh,PackedMesh::PK_Physic);
+    PhysicVbo  vbo(std::move(physic));
+    });
+  }
+
+void AssetBenchmark::benchModel(const Asset& a, Sample& s) {
+  zenkit::ModelMesh mdm;
+  s.loadMs = timeMs([&]() {
+    auto reader = a.node->open_read();
+    mdm.load(reader.get());
+    });
+  s.buildMs = timeMs([&]() {
+    for(auto& m:mdm.meshes) {
+      PackedMesh pack(m);
+      }
+    for(auto& m:mdm.attachments) {
+      PackedMesh pack(m.second,PackedMesh::PK_Visual);
+      PhysicVbo  vbo(std::move(pack));
+      }
+    });
+  }
+
+void AssetBenchmark::benchWorld(const Asset& a, Sample& s) {
+  zenkit::World world;
+  s.loadMs = timeMs([&]() {
+    auto reader = a.node->open_read();
+    world.load(reader.get(), Gothic::inst().version().game==1 ? zenkit::GameVersion::GOTHIC_1
+                                                               : zenkit::GameVersion::GOTHIC_2);
+    });
+  s.buildMs = timeMs([&]() {
+    auto& worldMesh = world.world_mesh;
+    PackedMesh visual(worldMesh,PackedMesh::PK_VisualLnd);
+
+    // same as DynamicWorld: landscape physics shares single vertex buffer
+    PackedMesh pkg(worldMesh,PackedMesh::PK_Physic);
+    std::vector<btVector3> landVbo(pkg.vertices.size());
+    for(size_t i=0; i<pkg.vertices.size(); ++i) {
+      auto v = pkg.vertices[i];
+      landVbo[i] = CollisionWorld::toMeters(Tempest::Vec3(v.pos[0],v.pos[1],v.pos[2]));
+      }
+    PhysicVbo landMesh(&landVbo);
+    for(auto& sm:pkg.subMeshes)
+      if(!sm.material.disable_collision && sm.iboLength>0)
+        landMesh.addIndex(pkg.indices,sm.iboOffset,sm.iboLength,sm.material.group);
+    });
+  }
+
+void AssetBenchmark::benchAnimation(const Asset& a, Sample& s) {
+  zenkit::ModelScript mds;
+  s.loadMs = timeMs([&]() {
+    auto reader = a.node->open_read();
+    mds.load(reader.get());
+    });
+  s.buildMs = timeMs([&]() {
+    // loads all referenced MAN files
+    Animation anim(mds,std::string_view(a.name).substr(0,a.name.size()-4),false);
+    });
+  }
+
+void AssetBenchmark::benchSkeleton(const Asset& a, Sample& s) {
+  zenkit::ModelHierarchy mdh;
+  s.loadMs = timeMs([&]() {
+    auto reader = a.node->open_read();
+    mdh.load(reader.get());
+    });
+  std::unique_ptr<Skeleton> sk;
+  s.buildMs = timeMs([&]() {
+    sk.reset(new Skeleton(mdh,nullptr,a.name));
+    });
+
+  // same as MdlVisual: bind separate mesh of the model to this skeleton
+  std::string mdmName = a.name;
+  FileExt::exchangeExt(mdmName,"MDH","MDM");
+  const auto* mdm = Resources::vdfsIndex().find(mdmName);
+  if(mdm==nullptr)
+    return;
+
+  // mesh setup is not part of this asset numbers
+  const uint64_t allocs = allocCount;
+  zenkit::ModelMesh lib;
+  {
+  auto reader = mdm->open_read();
+  lib.load(reader.get());
+  }
+  ProtoMesh proto(lib,nullptr,mdmName);
+  allocCount = allocs;
+
+  s.bindMs = timeMs([&]() {
+    AttachBinder bind(*sk,proto);
+    });
+  }
+
+void AssetBenchmark::benchTexture(const Asset& a, Sample& s) {
+  zenkit::Texture tex;
+  s.loadMs = timeMs([&]() {
+    auto reader = a.node->open_read();
+    tex.load(reader.get());
+    });
+  s.buildMs = timeMs([&]() {
+    if(tex.format() == zenkit::TextureFormat::DXT1 ||
+       tex.format() == zenkit::TextureFormat::DXT2 ||
+       tex.format() == zenkit::TextureFormat::DXT3 ||
+       tex.format() == zenkit::TextureFormat::DXT4 ||
+       tex.format() == zenkit::TextureFormat::DXT5) {
+      auto dds = zenkit::to_dds(tex);
+      Tempest::MemReader rd(reinterpret_cast<uint8_t*>(dds.data()), dds.size());
+      Tempest::Pixmap    pm(rd);
+      } else {
+      auto rgba = tex.as_rgba8(0);
+      Tempest::Pixmap pm(tex.width(), tex.height(), TextureFormat::RGBA8);
+      std::memcpy(pm.data(), rgba.data(), rgba.size());
+      }
+    });
+  }
+
+void AssetBenchmark::benchVideo(const Asset& a, Sample& s) {
+  // long intro videos would dominate the run otherwise
+  static constexpr size_t MaxFrames = 250;
+
+  auto reader = a.node->open_read();
+  BinkInput input(*reader);
+  std::unique_ptr<Bink::Video> vid;
+  s.loadMs = timeMs([&]() {
+    vid.reset(new Bink::Video(&input));
+    });
+  s.buildMs = timeMs([&]() {
+    const size_t count = std::min(vid->frameCount(), MaxFrames);
+    for(size_t i=0; i<count; ++i)
+      vid->nextFrame();
+    });
+  }
+
+void AssetBenchmark::benchMusic(const Asset& a, Sample& s) {
+  static constexpr size_t SampleRate = 44100;
+  static constexpr size_t Duration   = 10;
+  static constexpr size_t Chunk      = 4096;
+
+  std::optional<Dx8::PatternList> p;
+  s.loadMs = timeMs([&]() {
+    p.emplace(Resources::loadDxMusic(a.name));
+    });
+  s.buildMs = timeMs([&]() {
+    Dx8::Music m;
+    m.addPattern(*p);
+
+    Dx8::Mixer mix;
+    mix.setMusic(m);
+
+    std::vector<int16_t> pcm(Chunk*2);
+    for(size_t i=0; i<SampleRate*Duration; i+=Chunk)
+      mix.mix(pcm.data(), Chunk);
+    });
+  }
+
+bool AssetBenchmark::writeReport(const std::vector<Sample>& samples) const {
+  auto escape = [](std::string_view str) {
+    std::string ret;
+    for(auto c:str) {
+      if(c=='"' || c=='\\')
+        ret.push_back('\\');
+      ret.push_back(c);
+      }
+    return ret;
+    };
+
+  std::stringstream s;
+  s << std::fixed << std::setprecision(3);
+  s << "{\n\"assets\":[";
+  for(size_t i=0; i<samples.size(); ++i) {
+    auto& a = samples[i];
+    s << (i==0 ? "\n" : ",\n");
+    s << "{\"type\":\"" << kindName(a.kind) << "\",\"name\":\"" << escape(a.name) << "\""
+      << ",\"bytes\":" << a.bytes << ",\"loadMs\":" << a.loadMs << ",\"buildMs\":" << a.buildMs << ",\"bindMs\":" << a.bindMs
+      << ",\"allocs\":" << a.allocs << ",\"failed\":" << (a.failed ? "true" : "false") << "}";
+    }
+  s << "\n],\n\"summary\":{";
+
+  bool first = true;
+  for(uint8_t k=0; k<K_Count; ++k) {
+    size_t   count = 0, failed = 0;
+    double   ms    = 0;
+    uint64_t bytes = 0, alloc = 0;
+    for(auto& a:samples) {
+      if(a.kind!=k)
+        continue;
+      ++count;
+      failed += a.failed ? 1 : 0;
+      ms     += a.loadMs + a.buildMs + a.bindMs;
+      bytes  += a.bytes;
+      alloc  += a.allocs;
+      }
+    if(count==0)
+      continue;
+    const double sec = ms/1000.0;
+    s << (first ? "\n" : ",\n");
+    s << "\"" << kindName(Kind(k)) << "\":{\"count\":" << count << ",\"failed\":" << failed
+      << ",\"totalMs\":" << ms
+      << ",\"assetsPerSec\":" << (sec>0 ? double(count)/sec : 0.0)
+      << ",\"mbPerSec\":" << (sec>0 ? double(bytes)/(1024.0*1024.0)/sec : 0.0)
+      << ",\"allocs\":" << alloc << "}";
+    first = false;
+    }
+  s << "\n}\n}\n";
+
+  try {
+    auto str = s.str();
+    WFile f(output.c_str());
+    f.write(str.data(),str.size());
+    f.flush();
+    }
+  catch(...) {
+    Log::e("unable to write asset benchmark report: \"",output,"\"");
+    return false;
+    }
+  Log::i("Asset benchmark: report written to \"",output,"\"");
+  return true;
+  }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace zenkit {
+class VfsNode;
+}
+
+class CommandLine;
+
+// Runs asset conversion hot paths (mesh packing, physics, animation, skeleton binding, textures, video, music)
+// over all game assets. Works on cpu-side data only. Reports per-asset timings and allocation counts as json.
+class AssetBenchmark final {
+  public:
+    explicit AssetBenchmark(const CommandLine& cmd);
+
+    int exec();
+
+  private:
+    enum Kind : uint8_t {
+      K_Mesh,
+      K_Model,
+      K_World,
+      K_Animation,
+      K_Skeleton,
+      K_Texture,
+      K_Video,
+      K_Music,
+      K_Count,
+      };
+
+    struct Asset {
+      Kind                   kind = K_Count;
+      std::string            name;
+      const zenkit::VfsNode* node = nullptr;
+      std::u16string         path;
+      };
+
+    struct Sample {
+      Kind        kind    = K_Count;
+      std::string name;
+      double      loadMs  = 0;
+      double      buildMs = 0;
+      double      bindMs  = 0;
+      uint64_t    allocs  = 0;
+      uint64_t    bytes   = 0;
+      bool        failed  = false;
+      };
+
+    static const char* kindName(Kind k);
+
+    void   collect(const zenkit::VfsNode& node);
+    void   collectMusic();
+    Sample run(const Asset& a);
+
+    void   benchMesh     (const Asset& a, Sample& s);
+    void   benchModel    (const Asset& a, Sample& s);
+    void   benchWorld    (const Asset& a, Sample& s);
+    void   benchAnimation(const Asset& a, Sample& s);
+    void   benchSkeleton (const Asset& a, Sample& s);
+    void   benchTexture  (const Asset& a, Sample& s);
+    void   benchVideo    (const Asset& a, Sample& s);
+    void   benchMusic    (const Asset& a, Sample& s);
+
+    bool   writeReport(const std::vector<Sample>& samples) const;
+
+    std::string        output;
+    std::vector<Asset> assets;
+  };
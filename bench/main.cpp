@@ -0,0 +1,30 @@
+#include <Tempest/Log>
+
+#include <zenkit/Logger.hh>
+
+#include "utils/crashlog.h"
+#include "utils/workers.h"
+#include "assetbenchmark.h"
+#include "gothic.h"
+#include "resources.h"
+#include "build.h"
+#include "commandline.h"
+
+// Asset pipeline benchmark, no graphics device required:
+//   bench -g <gothic directory> [-report <report.json>]
+int main(int argc,const char** argv) {
+  zenkit::Logger::set(zenkit::LogLevel::ERROR, [] (zenkit::LogLevel, const char*, const char* message) {
+    Tempest::Log::e("[zenkit] ", message);
+    });
+  CrashLog::setup();
+
+  Tempest::Log::i(appBuild);
+  Workers::setThreadName("Main thread");
+
+  CommandLine    cmd{argc,argv};
+  Resources      resources;
+  Gothic         gothic;
+
+  AssetBenchmark bench(cmd);
+  return bench.exec();
+  }
@@ -90,6 +90,55 @@ CommandLine::CommandLine(int argc, const char** argv) {
         isBenchmark = std::string_view(argv[i])=="ci" ? Benchmark::CiTooling : isBenchmark;
         }
       }
+    else if(arg=="-simbench") {
+      ++i;
+      if(i<argc) {
+        try {
+          simBenchHours = std::max(0.f, std::stof(std::string(argv[i])));
+          }
+        catch (const std::exception& e) {
+          Log::i("failed to read simulation benchmark duration: \"", std::string(argv[i]), "\"");
+          }
+        }
+      }
+    else if(arg=="-simstep") {
+      ++i;
+      if(i<argc) {
+        try {
+          simBenchStep = std::max(1u, uint32_t(std::stoul(std::string(argv[i]))));
+          }
+        catch (const std::exception& e) {
+          Log::i("failed to read simulation benchmark step: \"", std::string(argv[i]), "\"");
+          }
+        }
+      }
+    else if(arg=="-simcrowd") {
+      ++i;
+      if(i<argc) {
+        try {
+          simBenchCrowd = uint32_t(std::stoul(std::string(argv[i])));
+          }
+        catch (const std::exception& e) {
+          Log::i("failed to read simulation benchmark crowd size: \"", std::string(argv[i]), "\"");
+          }
+        }
+      }
+    else if(arg=="-simseed") {
+      ++i;
+      if(i<argc) {
+        try {
+          simBenchSeed = uint32_t(std::stoul(std::string(argv[i])));
+          }
+        catch (const std::exception& e) {
+          Log::i("failed to read simulation benchmark seed: \"", std::string(argv[i]), "\"");
+          }
+        }
+      }
+    else if(arg=="-report") {
+      ++i;
+      if(i<argc)
+        assetBenchOut = argv[i];
+      }
     else if(arg=="-g1") {
       forceG1 = true;
       }
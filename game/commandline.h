@@ -43,6 +43,11 @@ class CommandLine {
     bool                isSoftwareShadow() const { return isRtSm;       }
     bool                doStartMenu()      const { return !noMenu;      }
     Benchmark           isBenchmarkMode()  const { return isBenchmark;  }
+    float               simBenchmarkHours() const { return simBenchHours; }
+    uint32_t            simBenchmarkStep()  const { return simBenchStep;  }
+    uint32_t            simBenchmarkCrowd() const { return simBenchCrowd; }
+    uint32_t            simBenchmarkSeed()  const { return simBenchSeed;  }
+    std::string_view    assetBenchmarkOutput() const { return assetBenchOut; } // 'bench' executable only
     bool                doForceG1()        const { return forceG1;      }
     bool                doForceG2()        const { return forceG2;      }
     bool                doForceG2NR()      const { return forceG2NR;    }
@@ -62,6 +67,11 @@ class CommandLine {
     bool                devmode      = false;
     bool                noMenu       = false;
     Benchmark           isBenchmark  = Benchmark::None;
+    float               simBenchHours = 0;
+    uint32_t            simBenchStep  = 20;
+    uint32_t            simBenchCrowd = 0;
+    uint32_t            simBenchSeed  = 0;
+    std::string         assetBenchOut;
     bool                isWindow     = false;
     bool                isDebug      = false;
 #if defined(__OSX__)
@@ -72,7 +72,7 @@ const std::string& Ikarus::memory_instance::get_string(const zenkit::DaedalusSym
   }
 
 
-Ikarus::Ikarus(GameScript& /*owner*/, zenkit::DaedalusVm& vm) : vm(vm) {
+Ikarus::Ikarus(GameScript& owner, zenkit::DaedalusVm& vm) : owner(owner), vm(vm) {
   Log::i("DMA mod detected: Ikarus");
 
   // built-in data with assumed address
@@ -224,18 +224,18 @@ Ikarus::Ikarus(GameScript& /*owner*/, zenkit::DaedalusVm& vm) : vm(vm) {
   vm.override_function("MEM_SendToSpy", [this](int cat, std::string_view msg){ return mem_sendtospy(cat,msg); });
 
   // ## Constants
-  if(auto v = vm.find_symbol_by_name("CurrSymbolTableLength")) {
+  if(auto v = owner.findSymbol("CurrSymbolTableLength")) {
     v->set_int(int(vm.symbols().size()));
     }
 
   // ## Traps
-  if(auto end = vm.find_symbol_by_name("END")) {
+  if(auto end = owner.findSymbol("END")) {
     end->set_access_trap_enable(true);
     }
-  if(auto break_ = vm.find_symbol_by_name("BREAK")) {
+  if(auto break_ = owner.findSymbol("BREAK")) {
     break_->set_access_trap_enable(true);
     }
-  if(auto continue_ = vm.find_symbol_by_name("CONTINUE")) {
+  if(auto continue_ = owner.findSymbol("CONTINUE")) {
     continue_->set_access_trap_enable(true);
     }
 
@@ -408,7 +408,7 @@ int Ikarus::mem_searchvobbyname(std::string_view name) {
   }
 
 int Ikarus::mem_getsymbolindex(std::string_view name) {
-  auto sym = vm.find_symbol_by_name(name);
+  auto sym = owner.findSymbol(name);
   if(sym==nullptr)
     return 0;// NULL-like
   return int32_t(sym->index());
@@ -621,9 +621,9 @@ void Ikarus::loop_trap(zenkit::DaedalusSymbol* i) {
   }
 
 void Ikarus::loop_out(zenkit::DaedalusVm& vm) {
-  auto end = vm.find_symbol_by_name("END");
-  auto rep = vm.find_symbol_by_name("REPEAT");
-  auto whl = vm.find_symbol_by_name("WHILE");
+  auto end = owner.findSymbol("END");
+  auto rep = owner.findSymbol("REPEAT");
+  auto whl = owner.findSymbol("WHILE");
 
   uint32_t repAddr = (rep!=nullptr ? rep->address() : uint32_t(-1));
   uint32_t whlAddr = (whl!=nullptr ? whl->address() : uint32_t(-1));
@@ -356,6 +356,7 @@ class Ikarus : public ScriptPlugin {
     void call__stdcall(ptr32_t func);
     int  hash(int x);
 
+    GameScript&         owner;
     zenkit::DaedalusVm& vm;
     Mem32               allocator;
     
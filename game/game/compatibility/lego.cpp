@@ -87,7 +87,7 @@ int LeGo::create(int instId) {
   auto ptr  = ikarus.mem_alloc(int32_t(sz), cls->name().c_str());
   auto inst = std::make_shared<Ikarus::memory_instance>(ikarus, ptr);
 
-  auto self = vm.find_symbol_by_name("SELF");
+  auto self = owner.findSymbol("SELF");
   auto prev = self != nullptr ? self->get_instance() : nullptr;
   if(self!=nullptr)
     self->set_instance(inst);
@@ -112,8 +112,8 @@ void LeGo::tick(uint64_t dt) {
     if(auto* sym = vm.find_symbol_by_index(i.fncID)) {
       try {
       if(i.hasData)
-        vm.call_function(sym, i.data); else
-        vm.call_function(sym);
+        owner.callFunction(sym, i.data); else
+        owner.callFunction(sym);
         }
       catch(const std::exception& e){
         Tempest::Log::e("exception in \"", sym->name(), "\": ",e.what());
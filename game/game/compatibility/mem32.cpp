@@ -3,309 +3,508 @@
 #include <Tempest/Log>
 #include <cassert>
 #include <cstring>
+#include <cstdlib>
 #include <algorithm>
 #include <cstddef>
+#include <iterator>
 
 using namespace Tempest;
 
+static const uint32_t slabClass[] = {8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048};
+static constexpr uint8_t slabClassCount = uint8_t(std::size(slabClass));
+
 Mem32::Mem32() {
   /*
    *  [0x00001000 .. 0x80000000] - (2GB) user space
    *  [0x80000000 .. 0xc0000000] - (1GB) extra space(reserved for opengothic use; pinned memory)
    *  [0xc0000000 .. 0xffffffff] - (1GB) kernel space
    */
-  region.emplace_back(Region(0x1000,0x80000000));
+  pages.free(UserBegin, UserEnd-UserBegin);
+  partial.resize(slabClassCount);
   }
 
 Mem32::~Mem32() {
-  for(auto& rgn:region) {
-    if(rgn.status==S_Allocated && rgn.real!=nullptr) {
-      std::free(rgn.real);
-      rgn.real = nullptr;
+  for(auto& b:blocks) {
+    if(b.status==S_Allocated && b.real!=nullptr) {
+      std::free(b.real);
+      b.real = nullptr;
       }
     }
+  for(auto& s:slabs) {
+    std::free(s.mem);
+    s.mem = nullptr;
+    }
   }
 
 Mem32::ptr32_t Mem32::pin(void* mem, ptr32_t address, uint32_t size, const char* comment) {
-  if(auto rgn = implAllocAt(address,size)) {
-    rgn->size    = size;
-    rgn->real    = mem;
-    rgn->status  = S_Pin;
-    rgn->comment = comment;
-    return address;
-    }
-  return 0;
+  return implAllocAt(address,size,mem,S_Pin,comment);
   }
 
 Mem32::ptr32_t Mem32::pin(void* mem, uint32_t size, const char* comment) {
-  if(auto rgn = implAlloc(size)) {
-    rgn->size    = size;
-    rgn->real    = mem;
-    rgn->status  = S_Pin;
-    rgn->comment = comment;
-    return rgn->address;
-    }
-  return 0;
+  return implAllocPages(size,mem,S_Pin,comment);
   }
 
 Mem32::ptr32_t Mem32::alloc(ptr32_t address, uint32_t size, const char* comment) {
-  if(auto rgn = implAllocAt(address,size)) {
-    rgn->real = std::calloc(size,1);
-    if(rgn->real==nullptr) {
-      compactage();
-      return 0;
-      }
-    rgn->size    = size;
-    rgn->status  = S_Allocated;
-    rgn->comment = comment;
-    return address;
-    }
-  return 0;
+  if(address==0)
+    return alloc(size,comment);
+  void* real = std::calloc(std::max(size,1u),1);
+  if(real==nullptr)
+    return 0;
+  auto ret = implAllocAt(address,size,real,S_Allocated,comment);
+  if(ret==0)
+    std::free(real);
+  return ret;
   }
 
 Mem32::ptr32_t Mem32::alloc(uint32_t size, const char* comment) {
-  if(auto rgn = implAlloc(size)) {
-    rgn->real = std::calloc(size,1);
-    if(rgn->real==nullptr) {
-      compactage();
-      return 0;
-      }
-    rgn->status  = S_Allocated;
-    rgn->comment = comment;
-    return rgn->address;
-    }
-  return 0;
+  size = alignSize(std::max(size,1u));
+  if(sizeClass(size)<slabClassCount)
+    return implAllocSmall(size);
+
+  void* real = std::calloc(size,1);
+  if(real==nullptr)
+    return 0;
+  auto ret = implAllocPages(size,real,S_Allocated,comment);
+  if(ret==0)
+    std::free(real);
+  return ret;
   }
 
 void Mem32::free(ptr32_t address) {
   if(address==0)
     return;
-  for(size_t i=0; i<region.size(); ++i) {
-    if(region[i].address!=address)
-      continue;
-    std::free(region[i].real);
-    region[i].real   = nullptr;
-    region[i].status = S_Unused;
-    compactage();
-    return;
+
+  if(auto e = page(address >> PageBits)) {
+    switch(e->kind) {
+      case P_None:
+        break;
+      case P_Block:
+        if(blocks[e->id].address==address) {
+          freeBlock(e->id);
+          return;
+          }
+        break;
+      case P_Slab: {
+        const uint32_t slabId = e->id;
+        auto&          s      = slabs[slabId];
+        const uint32_t cls    = slabClass[s.cls];
+        const uint32_t off    = address - (s.page << PageBits);
+        const uint32_t slot   = off/cls;
+        if(off%cls==0 && slot<s.size.size() && s.size[slot]!=0) {
+          implFreeSmall(s,slabId,slot);
+          return;
+          }
+        break;
+        }
+      case P_Shared:
+        for(auto id:shared[e->id].blocks) {
+          if(blocks[id].address==address) {
+            freeBlock(id);
+            return;
+            }
+          }
+        break;
+      }
     }
   Log::e("mem_free: heap block wan't allocated by script: ", reinterpret_cast<void*>(uint64_t(address)));
   }
 
+Mem32::ptr32_t Mem32::realloc(ptr32_t address, uint32_t size) {
+  size = alignSize(std::max(size,1u));
+  if(address==0)
+    return alloc(size);
+
+  Span cur;
+  bool pinned = false;
+  if(!allocation(address,cur,pinned)) {
+    Log::e("realloc: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
+    return alloc(size);
+    }
+  if(pinned) {
+    Log::e("realloc: unable to reallocate pinned memory: ", reinterpret_cast<void*>(uint64_t(address)));
+    return 0;
+    }
+
+  // in place, if allocation stays in the same slab slot or in the same set of pages
+  auto& e = *page(address >> PageBits);
+  if(e.kind==P_Slab) {
+    auto&          s    = slabs[e.id];
+    const uint32_t slot = (address - (s.page << PageBits))/slabClass[s.cls];
+    if(size<=slabClass[s.cls]) {
+      if(size>s.size[slot])
+        std::memset(cur.ptr+s.size[slot], 0, size-s.size[slot]);
+      s.size[slot] = size;
+      return address;
+      }
+    }
+  else if(e.kind==P_Block) {
+    auto& b = blocks[e.id];
+    if(pageCount(size)==pageCount(b.size) && sizeClass(size)>=slabClassCount) {
+      if(auto next = std::realloc(b.real, size)) {
+        if(size>b.size)
+          std::memset(reinterpret_cast<uint8_t*>(next)+b.size, 0, size-b.size);
+        b.real = next;
+        b.size = size;
+        return address;
+        }
+      return 0;
+      }
+    }
+
+  auto ret = alloc(size);
+  if(ret==0)
+    return 0;
+  Span next;
+  translate(ret,next);
+  std::memcpy(next.ptr, cur.ptr, std::min(cur.size,size));
+  free(address);
+  return ret;
+  }
+
 void* Mem32::deref(ptr32_t address, uint32_t size) {
-  auto rgn = translate(address);
-  if(rgn==nullptr) {
+  Span s;
+  if(!translate(address,s)) {
     Log::e("deref: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
     return nullptr;
     }
-  if(rgn->address+rgn->size < address+size) {
+  if(s.size<size) {
     Log::e("deref: memmory block is too small: ", reinterpret_cast<void*>(uint64_t(address)), " ", size);
     return nullptr;
     }
-  address -= rgn->address;
-  return reinterpret_cast<uint8_t*>(rgn->real)+address;
-  }
-
-void Mem32::compactage() {
-  for(size_t i=0; i+1<region.size(); ) {
-    auto& a = region[i+0];
-    auto& b = region[i+1];
-    if(a.status==S_Unused && a.status==b.status && a.address+a.size==b.address) {
-      a.size += b.size;
-      b.size = 0;
-      region.erase(region.begin()+ptrdiff_t(i+1));
-      } else {
-      ++i;
-      }
-    }
+  return s.ptr;
   }
 
 void Mem32::writeInt(ptr32_t address, int32_t v) {
-  auto rgn = translate(address);
-  if(rgn==nullptr) {
+  Span s;
+  if(!translate(address,s) || s.size<4) {
     Log::e("mem_writeint: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
     return;
     }
-  address -= rgn->address;
-  auto ptr = reinterpret_cast<uint8_t*>(rgn->real)+address;
-  std::memcpy(ptr,&v,4);
+  std::memcpy(s.ptr,&v,4);
   }
 
 int32_t Mem32::readInt(ptr32_t address) {
-  auto rgn = translate(address);
-  if(rgn==nullptr) {
+  Span s;
+  if(!translate(address,s) || s.size<4) {
     Log::e("mem_readint:  address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
     return 0;
     }
-  address -= rgn->address;
-  auto ptr = reinterpret_cast<uint8_t*>(rgn->real)+address;
   int32_t ret = 0;
-  std::memcpy(&ret,ptr,4);
+  std::memcpy(&ret,s.ptr,4);
   return ret;
   }
 
 void Mem32::copyBytes(ptr32_t psrc, ptr32_t pdst, uint32_t size) {
-  auto src = translate(psrc);
-  auto dst = translate(pdst);
-  if(src==nullptr || src->status==S_Unused) {
+  Span src, dst;
+  if(!translate(psrc,src)) {
     Log::e("mem_copybytes: address translation failure: ", reinterpret_cast<void*>(uint64_t(psrc)));
     return;
     }
-  if(dst==nullptr || dst->status==S_Unused) {
+  if(!translate(pdst,dst)) {
     Log::e("mem_copybytes: address translation failure: ", reinterpret_cast<void*>(uint64_t(pdst)));
     return;
     }
 
-  size_t sOff = psrc - src->address;
-  size_t dOff = pdst - dst->address;
-  size_t sz   = size;
-  if(src->size<sOff+size) {
+  uint32_t sz = size;
+  if(src.size<size) {
     Log::e("mem_copybytes: copy-size exceed source block size: ", size);
-    sz = std::min(src->size-sOff,sz);
+    sz = std::min(src.size,sz);
     }
-  if(dst->size<dOff+size) {
+  if(dst.size<size) {
     Log::e("mem_copybytes: copy-size exceed destination block size: ", size);
-    sz = std::min(dst->size-dOff,sz);
+    sz = std::min(dst.size,sz);
     }
-  std::memcpy(reinterpret_cast<uint8_t*>(dst->real)+sOff,
-              reinterpret_cast<uint8_t*>(src->real)+dOff,
-              sz);
+  std::memmove(dst.ptr, src.ptr, sz);
+  }
+
+uint8_t Mem32::sizeClass(uint32_t size) {
+  for(uint8_t i=0; i<slabClassCount; ++i)
+    if(size<=slabClass[i])
+      return i;
+  return slabClassCount;
   }
 
-Mem32::Region* Mem32::implAlloc(uint32_t size) {
-  size = ((size+memAlign-1)/memAlign)*memAlign;
+Mem32::PageEntry* Mem32::page(uint32_t p) {
+  auto& t = dir[p >> TableBits];
+  if(t==nullptr)
+    return nullptr;
+  return &(*t)[p & (TableSize-1)];
+  }
 
-  for(size_t i=0; i<region.size(); ++i) {
-    if(region[i].status!=S_Unused || region[i].size<size)
-      continue;
-    if(size!=region[i].size) {
-      auto p2 = region[i];
-      p2.address+=size;
-      p2.size   -=size;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
-      }
-    region[i].size = size;
-    return &region[i];
+const Mem32::PageEntry* Mem32::page(uint32_t p) const {
+  auto& t = dir[p >> TableBits];
+  if(t==nullptr)
+    return nullptr;
+  return &(*t)[p & (TableSize-1)];
+  }
+
+void Mem32::mapPages(uint32_t p, uint32_t count, PageKind kind, uint32_t id) {
+  for(uint32_t i=p; i<p+count; ++i) {
+    auto& t = dir[i >> TableBits];
+    if(t==nullptr)
+      t.reset(new PageTable());
+    auto& e = (*t)[i & (TableSize-1)];
+    e.kind = kind;
+    e.id   = id;
     }
+  }
 
-  return nullptr;
+void Mem32::releasePages(uint32_t p, uint32_t count) {
+  mapPages(p,count,P_None,nil);
+  // only user-space is managed by allocator; pages outside of it are fixed reservations
+  const uint32_t b = std::max(p,UserBegin);
+  const uint32_t e = std::min(p+count,UserEnd);
+  if(b<e)
+    pages.free(b,e-b);
   }
 
-Mem32::ptr32_t Mem32::realloc(ptr32_t address, uint32_t size) {
-  size = ((size+memAlign-1)/memAlign)*memAlign;
-  if(implRealloc(address,size))
-    return address;
+uint32_t Mem32::mkBlock(ptr32_t address, uint32_t size, void* real, Status st, const char* comment) {
+  uint32_t id = 0;
+  if(!freeBlocks.empty()) {
+    id = freeBlocks.back();
+    freeBlocks.pop_back();
+    } else {
+    id = uint32_t(blocks.size());
+    blocks.emplace_back();
+    }
+  auto& b   = blocks[id];
+  b.address = address;
+  b.size    = size;
+  b.real    = real;
+  b.status  = st;
+  b.comment = comment;
+  return id;
+  }
 
-  auto next = implAlloc(size);
-  if(next==nullptr)
-    return 0;
+void Mem32::freeBlock(uint32_t id) {
+  auto& b = blocks[id];
+  if(b.status==S_Allocated)
+    std::free(b.real);
 
-  auto src = translate(address);
-  if(src==nullptr) {
-    if(address!=0)
-      Log::e("realloc: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
-    return next->address;
+  const uint32_t p0 = b.address >> PageBits;
+  const uint32_t p1 = (b.address + std::max(b.size,1u) - 1) >> PageBits;
+  for(uint32_t p=p0; p<=p1; ++p) {
+    auto e = page(p);
+    if(e==nullptr)
+      continue;
+    if(e->kind==P_Block) {
+      releasePages(p,1);
+      }
+    else if(e->kind==P_Shared) {
+      const uint32_t sh   = e->id;
+      auto&          list = shared[sh].blocks;
+      list.erase(std::remove(list.begin(),list.end(),id),list.end());
+      if(list.empty()) {
+        freeShared.push_back(sh);
+        releasePages(p,1);
+        }
+      }
     }
 
-  next->status  = S_Allocated;
-  next->real    = src->real;
-  next->comment = src->comment;
+  b = Block();
+  freeBlocks.push_back(id);
+  }
 
-  src->real     = nullptr;
-  src->status   = S_Unused;
+Mem32::ptr32_t Mem32::implAllocPages(uint32_t size, void* real, Status st, const char* comment) {
+  // NOTE: size is kept as-is, pinned blocks must not expose bytes past the host object
+  const uint32_t cnt = pageCount(std::max(size,1u));
+  const size_t   p   = pages.alloc(cnt);
+  if(p==RangeAllocator::npos)
+    return 0;
 
-  auto ret = next->address;
-  compactage();
-  return ret;
+  const ptr32_t address = ptr32_t(p << PageBits);
+  const uint32_t id     = mkBlock(address,size,real,st,comment);
+  mapPages(uint32_t(p),cnt,P_Block,id);
+  return address;
   }
 
-Mem32::Region* Mem32::implAllocAt(ptr32_t address, uint32_t size) {
-  for(size_t i=0; i<region.size(); ++i) {
-    auto& rgn = region[i];
+Mem32::ptr32_t Mem32::implAllocAt(ptr32_t address, uint32_t size, void* real, Status st, const char* comment) {
+  if(address==0)
+    return implAllocPages(size,real,st,comment);
 
-    if(address!=0) {
-      if(!(rgn.address<=address && address+size<=rgn.address+rgn.size))
-        continue;
-      } else {
-      if(rgn.size<size)
-        continue;
-      }
+  const uint64_t end = uint64_t(address) + std::max(size,1u);
+  if(end>uint64_t(0xFFFFFFFF)+1) {
+    Log::e("failed to pin a ",size," bytes of memory: out of address space");
+    return 0;
+    }
 
-    if(rgn.status!=S_Unused) {
+  const uint32_t p0 = address >> PageBits;
+  const uint32_t p1 = uint32_t((end-1) >> PageBits);
+  // validate: fixed blocks can share pages only with other fixed blocks, and must not overlap
+  for(uint32_t p=p0; p<=p1; ++p) {
+    auto e = page(p);
+    if(e==nullptr || e->kind==P_None)
+      continue;
+    if(e->kind!=P_Shared) {
       Log::e("failed to pin a ",size," bytes of memory: block is in use");
       return 0;
       }
+    for(auto id:shared[e->id].blocks) {
+      auto& b = blocks[id];
+      if(address<uint64_t(b.address)+b.size && b.address<end) {
+        Log::e("failed to pin a ",size," bytes of memory: block is in use");
+        return 0;
+        }
+      }
+    }
 
-    if(address==0)
-      address = region[i].address;
-
-    if(region[i].address<address) {
-      uint32_t off = (address-region[i].address);
-      auto p2 = region[i];
-      p2.address+=off;
-      p2.size   -=off;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
-      region[i].size = off;
-      ++i;
+  const uint32_t id = mkBlock(address,size,real,st,comment);
+  for(uint32_t p=p0; p<=p1; ++p) {
+    auto e = page(p);
+    if(e==nullptr || e->kind==P_None) {
+      if(UserBegin<=p && p<UserEnd)
+        pages.allocAt(p,1);
+      uint32_t sh = 0;
+      if(!freeShared.empty()) {
+        sh = freeShared.back();
+        freeShared.pop_back();
+        } else {
+        sh = uint32_t(shared.size());
+        shared.emplace_back();
+        }
+      shared[sh].blocks.clear();
+      mapPages(p,1,P_Shared,sh);
+      e = page(p);
       }
-    if(size!=region[i].size) {
-      auto p2 = region[i];
-      p2.address+=size;
-      p2.size   -=size;
-      region.insert(region.begin()+ptrdiff_t(i+1),p2);
+    shared[e->id].blocks.push_back(id);
+    }
+  return address;
+  }
+
+Mem32::ptr32_t Mem32::implAllocSmall(uint32_t size) {
+  const uint8_t cls   = sizeClass(size);
+  auto&         avail = partial[cls];
+
+  uint32_t slabId = avail.empty() ? nil : avail.back();
+  if(slabId==nil) {
+    const size_t p = pages.alloc(1);
+    if(p==RangeAllocator::npos)
+      return 0;
+    auto mem = reinterpret_cast<uint8_t*>(std::calloc(PageSize,1));
+    if(mem==nullptr) {
+      pages.free(p,1);
+      return 0;
+      }
+    if(!freeSlabs.empty()) {
+      slabId = freeSlabs.back();
+      freeSlabs.pop_back();
+      } else {
+      slabId = uint32_t(slabs.size());
+      slabs.emplace_back();
       }
+    auto&          s     = slabs[slabId];
+    const uint32_t count = PageSize/slabClass[cls];
+    s.page      = uint32_t(p);
+    s.cls       = cls;
+    s.inPartial = true;
+    s.used      = 0;
+    s.mem       = mem;
+    s.size.assign(count,0);
+    s.freeSlots.resize(count);
+    for(uint32_t i=0; i<count; ++i)
+      s.freeSlots[i] = uint16_t(count-i-1);
+    mapPages(uint32_t(p),1,P_Slab,slabId);
+    avail.push_back(slabId);
+    }
 
-    return &region[i];
+  auto&          s    = slabs[slabId];
+  const uint32_t slot = s.freeSlots.back();
+  s.freeSlots.pop_back();
+  s.size[slot] = size;
+  s.used++;
+  if(s.freeSlots.empty()) {
+    // slab is full now
+    avail.pop_back();
+    s.inPartial = false;
     }
-  return nullptr;
+  std::memset(s.mem + slot*slabClass[cls], 0, slabClass[cls]);
+  return ptr32_t((s.page << PageBits) + slot*slabClass[cls]);
   }
 
-bool Mem32::implRealloc(ptr32_t address, uint32_t nsize) {
-  // NOTE: in place only
-  for(size_t i=0; i<region.size(); ++i) {
-    auto& rgn = region[i];
-    if(rgn.address!=address)
-      continue;
-
-    if(nsize==rgn.size)
-      return true;
+void Mem32::implFreeSmall(Slab& s, uint32_t slabId, uint32_t slot) {
+  s.size[slot] = 0;
+  s.freeSlots.push_back(uint16_t(slot));
+  s.used--;
 
-    if(nsize<rgn.size) {
-      if(auto next = std::realloc(rgn.real, nsize))
-        rgn.real = next;
-      Region frgn(address+nsize, rgn.size-nsize);
-      rgn.size = nsize;
-      region.insert(region.begin() + intptr_t(i + 1), frgn);
-      return true;
+  if(s.used==0) {
+    if(s.inPartial) {
+      auto& avail = partial[s.cls];
+      avail.erase(std::find(avail.begin(),avail.end(),slabId));
+      s.inPartial = false;
       }
+    std::free(s.mem);
+    s.mem = nullptr;
+    s.size.clear();
+    s.freeSlots.clear();
+    releasePages(s.page,1);
+    freeSlabs.push_back(slabId);
+    return;
+    }
+  if(!s.inPartial) {
+    partial[s.cls].push_back(slabId); // was full
+    s.inPartial = true;
+    }
+  }
 
-    if(i+1==region.size())
-      return false; // can't expand
+bool Mem32::translate(ptr32_t address, Span& out) const {
+  auto e = page(address >> PageBits);
+  if(e==nullptr)
+    return false;
 
-    auto& rgn2 = region[i+1];
-    if(rgn2.status==S_Unused && rgn.size + rgn2.size>=nsize) {
-      auto next = std::realloc(rgn.real, nsize);
-      if(next==nullptr)
+  auto fromBlock = [address,&out](const Block& b) {
+    if(address<b.address || address-b.address>=b.size)
+      return false;
+    out.ptr  = reinterpret_cast<uint8_t*>(b.real) + (address-b.address);
+    out.size = b.size - (address-b.address);
+    return true;
+    };
+
+  switch(e->kind) {
+    case P_None:
+      return false;
+    case P_Block:
+      return fromBlock(blocks[e->id]);
+    case P_Slab: {
+      auto&          s    = slabs[e->id];
+      const uint32_t cls  = slabClass[s.cls];
+      const uint32_t off  = address - (s.page << PageBits);
+      const uint32_t slot = off/cls;
+      if(slot>=s.size.size() || off-slot*cls>=s.size[slot])
         return false;
-      rgn2.address += (nsize-rgn.size);
-      rgn2.size    -= (nsize-rgn.size);
-      rgn.real      = next;
-      rgn.size      = nsize;
-      if(rgn2.size==0)
-        compactage();
+      out.ptr  = s.mem + off;
+      out.size = s.size[slot] - (off-slot*cls);
       return true;
       }
-
-    return false;
+    case P_Shared:
+      for(auto id:shared[e->id].blocks)
+        if(fromBlock(blocks[id]))
+          return true;
+      return false;
     }
   return false;
   }
 
-Mem32::Region* Mem32::translate(ptr32_t address) {
-  // TODO: binary-search
-  for(auto& rgn:region) {
-    if(rgn.address<=address && address<rgn.address+rgn.size && rgn.status!=S_Unused)
-      return &rgn;
+bool Mem32::allocation(ptr32_t address, Span& out, bool& pinned) const {
+  if(!translate(address,out))
+    return false;
+
+  auto e = page(address >> PageBits);
+  if(e->kind==P_Slab) {
+    auto& s = slabs[e->id];
+    pinned  = false;
+    return (address - (s.page << PageBits))%slabClass[s.cls]==0;
     }
-  return nullptr;
+
+  const uint32_t id = e->kind==P_Block ? e->id : nil;
+  if(id!=nil) {
+    pinned = blocks[id].status==S_Pin;
+    return blocks[id].address==address;
+    }
+  for(auto i:shared[e->id].blocks) {
+    if(blocks[i].address==address) {
+      pinned = blocks[i].status==S_Pin;
+      return true;
+      }
+    }
+  return false;
   }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "utils/rangeallocator.h"
+
 class Mem32 {
   public:
     Mem32();
@@ -30,30 +35,93 @@ class Mem32 {
     void    copyBytes(ptr32_t src, ptr32_t dst, uint32_t size);
 
   private:
+    /*
+     * Two-level page table over 32-bit address space: [10 bit directory][10 bit table][12 bit offset]
+     * Small allocations are packed into per size-class slab pages, big ones and pinned memory own whole pages.
+     * Blocks at fixed addresses (pin/alloc with explicit address) may share a page - such pages keep a short list of blocks.
+     */
+    static constexpr uint32_t PageBits  = 12;
+    static constexpr uint32_t PageSize  = 1u << PageBits;
+    static constexpr uint32_t TableBits = 10;
+    static constexpr uint32_t TableSize = 1u << TableBits;
+    static constexpr uint32_t UserBegin = 0x00001000 >> PageBits;
+    static constexpr uint32_t UserEnd   = 0x80000000 >> PageBits;
+    static constexpr uint32_t nil       = uint32_t(-1);
+
     enum Status:uint8_t {
       S_Unused,
       S_Allocated,
       S_Pin,
       };
 
-    struct Region {
-      Region();
-      Region(ptr32_t b, uint32_t sz):address(b),size(sz){}
+    enum PageKind:uint8_t {
+      P_None,
+      P_Block,
+      P_Slab,
+      P_Shared,
+      };
+
+    struct PageEntry {
+      PageKind kind = P_None;
+      uint32_t id   = nil;
+      };
+    using PageTable = std::array<PageEntry,TableSize>;
+
+    struct Block {
+      ptr32_t     address = 0;
+      uint32_t    size    = 0;
+      void*       real    = nullptr;
+      const char* comment = nullptr;
+      Status      status  = S_Unused;
+      };
 
-      //std::function<void(ptr32_t offset)> callback;
-      ptr32_t                             address = 0;
-      uint32_t                            size    = 0;
-      void*                               real    = nullptr;
-      const char*                         comment = nullptr;
-      Status                              status  = S_Unused;
+    struct Slab {
+      uint32_t              page      = 0;
+      uint8_t               cls       = 0;
+      bool                  inPartial = false;
+      uint32_t              used      = 0;
+      uint8_t*              mem       = nullptr;
+      std::vector<uint32_t> size; // per slot, 0 - free
+      std::vector<uint16_t> freeSlots;
       };
 
-    Region*  implAlloc(uint32_t size);
-    Region*  implAllocAt(ptr32_t address, uint32_t size);
-    bool     implRealloc(ptr32_t address, uint32_t size);
-    Region*  translate(ptr32_t address);
-    void     compactage();
+    struct Shared {
+      std::vector<uint32_t> blocks;
+      };
 
-    std::vector<Region> region;
-  };
+    struct Span {
+      uint8_t* ptr  = nullptr;
+      uint32_t size = 0; // bytes until end of block
+      };
+
+    static uint32_t  alignSize(uint32_t size) { return ((size+memAlign-1)/memAlign)*memAlign; }
+    static uint32_t  pageCount(uint32_t size) { return (size+PageSize-1)/PageSize; }
+    static uint8_t   sizeClass(uint32_t size);
+
+    PageEntry*       page(uint32_t p);
+    const PageEntry* page(uint32_t p) const;
+    void             mapPages(uint32_t p, uint32_t count, PageKind kind, uint32_t id);
+    void             releasePages(uint32_t p, uint32_t count);
+
+    uint32_t         mkBlock(ptr32_t address, uint32_t size, void* real, Status st, const char* comment);
+    void             freeBlock(uint32_t id);
 
+    ptr32_t          implAllocPages(uint32_t size, void* real, Status st, const char* comment);
+    ptr32_t          implAllocAt(ptr32_t address, uint32_t size, void* real, Status st, const char* comment);
+    ptr32_t          implAllocSmall(uint32_t size);
+    void             implFreeSmall(Slab& s, uint32_t slabId, uint32_t slot);
+
+    bool             translate(ptr32_t address, Span& out) const;
+    bool             allocation(ptr32_t address, Span& out, bool& pinned) const;
+
+    std::array<std::unique_ptr<PageTable>,TableSize> dir;
+    RangeAllocator                                   pages;
+
+    std::vector<Block>                               blocks;
+    std::vector<uint32_t>                            freeBlocks;
+    std::vector<Slab>                                slabs;
+    std::vector<uint32_t>                            freeSlabs;
+    std::vector<Shared>                              shared;
+    std::vector<uint32_t>                            freeShared;
+    std::vector<std::vector<uint32_t>>               partial; // per size class: slabs with free slots, each slab at most once
+  };
@@ -16,6 +16,7 @@
 #include "world/triggers/abstracttrigger.h"
 #include "graphics/visualfx.h"
 #include "utils/fileutil.h"
+#include "utils/profiler.h"
 #include "commandline.h"
 #include "gothic.h"
 
@@ -75,12 +76,13 @@ int GameScript::PerDist::at(PercType perc, int r) const {
 
 
 GameScript::GameScript(GameSession &owner)
-    :owner(owner), vm(createVm(Gothic::inst())) {
+    :owner(owner), vm(createVm(Gothic::inst())), profiler(vm) {
   if (vm.global_self() == nullptr || vm.global_other() == nullptr || vm.global_item() == nullptr ||
       vm.global_victim() == nullptr || vm.global_hero() == nullptr)
     throw std::runtime_error("Cannot find script symbol SELF, OTHER, ITEM, VICTIM, or HERO! Cannot proceed!");
 
   vmLang = Gothic::inst().settingsGetI("GAME", "language");
+  randGen.seed(Gothic::inst().randomSeed());
   vm.register_exception_handler(zenkit::lenient_vm_exception_handler);
   Gothic::inst().setupCommonScriptClasses(vm);
   Gothic::inst().setupVmCommonApi(vm);
@@ -327,32 +329,32 @@ void GameScript::initCommon() {
   ZS_Attack            = aiState(findSymbolIndex("ZS_Attack")).funcIni;
   ZS_MM_Attack         = aiState(findSymbolIndex("ZS_MM_Attack")).funcIni;
 
-  spellFxInstanceNames = vm.find_symbol_by_name("spellFxInstanceNames");
-  spellFxAniLetters    = vm.find_symbol_by_name("spellFxAniLetters");
+  spellFxInstanceNames = findSymbol("spellFxInstanceNames");
+  spellFxAniLetters    = findSymbol("spellFxAniLetters");
 
   if(spellFxInstanceNames==nullptr || spellFxAniLetters==nullptr) {
     throw std::runtime_error("spellFxInstanceNames and/or spellFxAniLetters not found");
     }
 
   if(owner.version().game==2) {
-    auto* currency = vm.find_symbol_by_name("TRADE_CURRENCY_INSTANCE");
-    itMi_Gold      = currency!=nullptr ? vm.find_symbol_by_name(currency->get_string()) : nullptr;
+    auto* currency = findSymbol("TRADE_CURRENCY_INSTANCE");
+    itMi_Gold      = currency!=nullptr ? findSymbol(currency->get_string()) : nullptr;
     if(itMi_Gold!=nullptr){ // FIXME
       auto item = vm.init_instance<zenkit::IItem>(itMi_Gold);
       goldTxt = item->name;
       }
-    auto* tradeMul = vm.find_symbol_by_name("TRADE_VALUE_MULTIPLIER");
+    auto* tradeMul = findSymbol("TRADE_VALUE_MULTIPLIER");
     tradeValMult   = tradeMul != nullptr ? tradeMul->get_float() : 1.0f;
 
-    auto* vtime     = vm.find_symbol_by_name("VIEW_TIME_PER_CHAR");
+    auto* vtime     = findSymbol("VIEW_TIME_PER_CHAR");
     viewTimePerChar = vtime != nullptr ? vtime->get_float() : 550.f;
     if(viewTimePerChar<=0.f)
       viewTimePerChar = 550.f;
 
-    ItKE_lockpick     = vm.find_symbol_by_name("ItKE_lockpick");
-    B_RefreshAtInsert = vm.find_symbol_by_name("B_RefreshAtInsert");
+    ItKE_lockpick     = findSymbol("ItKE_lockpick");
+    B_RefreshAtInsert = findSymbol("B_RefreshAtInsert");
     } else {
-    itMi_Gold      = vm.find_symbol_by_name("ItMiNugget");
+    itMi_Gold      = findSymbol("ItMiNugget");
     if(itMi_Gold!=nullptr) { // FIXME
       auto item = vm.init_instance<zenkit::IItem>(itMi_Gold);
       goldTxt = item->name;
@@ -360,22 +362,22 @@ void GameScript::initCommon() {
     //
     tradeValMult    = 1.f;
     viewTimePerChar = 550.f;
-    ItKE_lockpick   = vm.find_symbol_by_name("itkelockpick");
+    ItKE_lockpick   = findSymbol("itkelockpick");
     }
 
-  if(auto v = vm.find_symbol_by_name("DAM_CRITICAL_MULTIPLIER")) {
+  if(auto v = findSymbol("DAM_CRITICAL_MULTIPLIER")) {
     damCriticalMultiplier = v->get_int();
     }
 
-  auto* gilMax = vm.find_symbol_by_name("GIL_MAX");
+  auto* gilMax = findSymbol("GIL_MAX");
   gilCount = gilMax!=nullptr ? size_t(gilMax->get_int()) : 0;
 
-  auto* tblSz = vm.find_symbol_by_name("TAB_ANZAHL");
+  auto* tblSz = findSymbol("TAB_ANZAHL");
   gilTblSize = tblSz!=nullptr ? size_t(std::sqrt(tblSz->get_int())) : 0;
   gilAttitudes.resize(gilCount*gilCount,ATT_HOSTILE);
   wld_exchangeguildattitudes("GIL_ATTITUDES");
 
-  auto id = vm.find_symbol_by_name("Gil_Values");
+  auto id = findSymbol("Gil_Values");
   if(id!=nullptr){
     cGuildVal = vm.init_instance<zenkit::IGuildValues>(id);
     for(size_t i=0;i<Guild::GIL_PUBLIC;++i){
@@ -422,6 +424,41 @@ void GameScript::initCommon() {
   if(LeGo::isRequired(vm)) {
     plugins.emplace_back(std::make_unique<LeGo>(*this,*ikarus,vm));
     }
+  initSymbolCache();
+  }
+
+void GameScript::initSymbolCache() {
+  // functions and constants, called by engine at runtime - resolve once, at load
+  static const char* engineSymbols[] = {
+    "initPerceptions", "startup_global", "init_global",
+    "G_CanNotUse", "G_CanNotCast", "G_PickLock",
+    "player_trade_not_enough_gold", "player_plunder_is_empty",
+    "player_mob_missing_item", "player_mob_missing_key", "player_mob_another_is_using",
+    "player_mob_missing_key_or_lockpick", "player_mob_missing_lockpick", "player_mob_too_far_away",
+    "player_hotkey_screen_map", "player_hotkey_lame_potion", "player_hotkey_lame_heal",
+    "Spell_ProcessMana", "Spell_ProcessMana_Release", "C_CanNpcCollideWithSpell",
+    "PLAYER_PERC_ASSESSMAGIC", "NPC_DAM_DIVE_TIME",
+    "itwrworldmap_orc", "itwrworldmap", "ItLsTorch", "ItLsTorchburned", "ItLsTorchburning",
+    };
+  for(auto name:engineSymbols)
+    findSymbol(name);
+
+  if(spellFxInstanceNames!=nullptr) {
+    for(uint32_t i=0; i<spellFxInstanceNames->count(); ++i) {
+      auto& tag = spellFxInstanceNames->get_string(uint16_t(i));
+      findSymbol(string_frm("Spell_Cast_",tag));
+      }
+    }
+
+  // ai-states: ScriptFn handles of ZS_X, ZS_X_Loop and ZS_X_End, otherwise resolved on first use of the state
+  for(auto& s:vm.symbols()) {
+    std::string_view name = s.name();
+    if(s.type()!=zenkit::DaedalusDataType::FUNCTION || !name.ends_with("_LOOP"))
+      continue;
+    auto* fn = vm.find_symbol_by_name(name.substr(0,name.size()-5));
+    if(fn!=nullptr && fn->type()==zenkit::DaedalusDataType::FUNCTION)
+      aiState(fn->index());
+    }
   }
 
 void GameScript::initSettings() {
@@ -436,10 +473,25 @@ void GameScript::initSettings() {
 void GameScript::initDialogs() {
   loadDialogOU();
 
+  // known-infos are stored by position in dialogsInfo - remap them, in case if list is rebuilt
+  const auto known = knownInfos();
+
   dialogsInfo.clear();
+  dialogsByNpc.clear();
+  dialogsId.clear();
+  dlgKnownInfos.clear();
   vm.enumerate_instances_by_class_name("C_INFO", [this](zenkit::DaedalusSymbol& sym){
     dialogsInfo.push_back(vm.init_instance<zenkit::IInfo>(&sym));
     });
+
+  for(size_t i=0; i<dialogsInfo.size(); ++i) {
+    auto& info = *dialogsInfo[i];
+    dialogsByNpc[info.npc].push_back(uint32_t(i));
+    dialogsId[info.symbol_index()] = uint32_t(i);
+    }
+
+  for(auto& i:known)
+    setInfoKnown(i.first,i.second);
   }
 
 void GameScript::loadDialogOU() {
@@ -511,7 +563,7 @@ void GameScript::initializeInstanceNpc(const std::shared_ptr<zenkit::INpc>& npc,
     auto* daily_routine = vm.find_symbol_by_index(uint32_t(npc->daily_routine));
 
     if(daily_routine != nullptr) {
-      vm.call_function(daily_routine);
+      callFunction(daily_routine);
       }
     }
   }
@@ -529,8 +581,9 @@ void GameScript::initializeInstanceItem(const std::shared_ptr<zenkit::IItem>& it
 
 void GameScript::saveQuests(Serialize &fout) {
   quests.save(fout);
-  fout.write(uint32_t(dlgKnownInfos.size()));
-  for(auto& i:dlgKnownInfos)
+  const auto known = knownInfos();
+  fout.write(uint32_t(known.size()));
+  for(auto& i:known)
     fout.write(uint32_t(i.first),uint32_t(i.second));
 
   fout.write(gilAttitudes);
@@ -543,7 +596,7 @@ void GameScript::loadQuests(Serialize& fin) {
   for(size_t i=0;i<sz;++i){
     uint32_t f=0,s=0;
     fin.read(f,s);
-    dlgKnownInfos.insert(std::make_pair(f,s));
+    setInfoKnown(f,s);
     }
 
   fin.read(gilAttitudes);
@@ -663,7 +716,7 @@ void GameScript::loadPerc(Serialize& fin) {
   fin.read(count);
   if(count!=PERC_Count) {
     if(hasSymbolName("initPerceptions"))
-      vm.call_function("initPerceptions");
+      callFunction("initPerceptions");
     return;
     }
   for(size_t i=0; i<PERC_Count; ++i)
@@ -787,7 +840,7 @@ World &GameScript::world() {
   }
 
 zenkit::IFocus GameScript::findFocus(std::string_view name) {
-  auto id = vm.find_symbol_by_name(name);
+  auto id = findSymbol(name);
   if(id==nullptr)
     return {};
   try {
@@ -808,7 +861,12 @@ void GameScript::storeItem(Item *itm) {
   }
 
 zenkit::DaedalusSymbol* GameScript::findSymbol(std::string_view s) {
-  return vm.find_symbol_by_name(s);
+  if(auto it = symbolCache.find(s); it!=symbolCache.end())
+    return it->second;
+  // symbol table is immutable after load - misses are cached as well
+  auto sym = vm.find_symbol_by_name(s);
+  symbolCache.emplace(std::string(s), sym);
+  return sym;
   }
 
 zenkit::DaedalusSymbol* GameScript::findSymbol(const size_t s) {
@@ -816,7 +874,7 @@ zenkit::DaedalusSymbol* GameScript::findSymbol(const size_t s) {
   }
 
 size_t GameScript::findSymbolIndex(std::string_view name) {
-  auto sym = vm.find_symbol_by_name(name);
+  auto sym = findSymbol(name);
   return sym == nullptr ? size_t(-1) : sym->index();
   }
 
@@ -847,22 +905,19 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<zen
                                                              std::shared_ptr<zenkit::INpc> hnpc,
                                                              const std::vector<uint32_t>& except,
                                                              bool includeImp) {
+  PROFILE_SCOPE("script: dialogChoices");
   ScopeVar self (*vm.global_self(),  hnpc);
   ScopeVar other(*vm.global_other(), player);
-  std::vector<zenkit::IInfo*> hDialog;
-  for(auto& info : dialogsInfo) {
-    if(info->npc==static_cast<int>(hnpc->symbol_index())) {
-      hDialog.push_back(info.get());
-      }
-    }
+  auto& hDialog = npcDialogs(*hnpc);
 
   std::vector<DlgChoice> choice;
   for(int important=includeImp ? 1 : 0;important>=0;--important){
-    for(auto& i:hDialog) {
+    for(auto id:hDialog) {
+      zenkit::IInfo* i = dialogsInfo[id].get();
       const zenkit::IInfo& info = *i;
       if(info.important!=important)
         continue;
-      bool npcKnowsInfo = doesNpcKnowInfo(*player,vm.find_symbol_by_instance(info)->index());
+      bool npcKnowsInfo = doesNpcKnowInfo(*player,info.symbol_index());
       if(npcKnowsInfo && !info.permanent)
         continue;
 
@@ -881,7 +936,7 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<zen
       if(info.condition) {
         auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info.condition));
         if (conditionSymbol != nullptr) {
-          valid = vm.call_function<int>(conditionSymbol) != 0;
+          valid = callFunction<int>(conditionSymbol) != 0;
           }
         }
       if(!valid)
@@ -929,6 +984,7 @@ std::vector<GameScript::DlgChoice> GameScript::updateDialog(const GameScript::Dl
   }
 
 void GameScript::exec(const GameScript::DlgChoice &dlg, Npc& player, Npc& npc) {
+  PROFILE_SCOPE("script: dialog");
   ScopeVar self (*vm.global_self(), npc.handlePtr());
   ScopeVar other(*vm.global_other(), player.handlePtr());
 
@@ -947,111 +1003,113 @@ void GameScript::exec(const GameScript::DlgChoice &dlg, Npc& player, Npc& npc) {
         ++i;
       }
     }
-  vm.call_function(vm.find_symbol_by_index(dlg.scriptFn));
+  callFunction(vm.find_symbol_by_index(dlg.scriptFn));
   }
 
 void GameScript::printCannotUseError(Npc& npc, int32_t atr, int32_t nValue) {
-  auto id = vm.find_symbol_by_name("G_CanNotUse");
+  auto id = findSymbol("G_CanNotUse");
   if(id==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id, npc.isPlayer(), atr, nValue);
+  callFunction<void>(id, npc.isPlayer(), atr, nValue);
   }
 
 void GameScript::printCannotCastError(Npc &npc, int32_t plM, int32_t itM) {
-  auto id = vm.find_symbol_by_name("G_CanNotCast");
+  auto id = findSymbol("G_CanNotCast");
   if(id==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id, npc.isPlayer(), itM, plM);
+  callFunction<void>(id, npc.isPlayer(), itM, plM);
   }
 
 void GameScript::printCannotBuyError(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_trade_not_enough_gold");
+  auto id = findSymbol("player_trade_not_enough_gold");
   if(id==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingItem(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_item");
+  auto id = findSymbol("player_mob_missing_item");
   if(id==nullptr) {
     if(owner.version().game==1)
       owner.player()->playAnimByName("T_DONTKNOW", BS_NONE);
     return;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingKey(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_key");
+  auto id = findSymbol("player_mob_missing_key");
   if(id==nullptr) {
     if(owner.version().game==1)
       owner.player()->playAnimByName("T_DONTKNOW", BS_NONE);
     return;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobAnotherIsUsing(Npc &npc) {
-  auto id = vm.find_symbol_by_name("player_mob_another_is_using");
+  auto id = findSymbol("player_mob_another_is_using");
   if(id==nullptr) {
     if(owner.version().game==1)
       owner.player()->playAnimByName("T_DONTKNOW", BS_NONE);
     return;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingKeyOrLockpick(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_key_or_lockpick");
+  auto id = findSymbol("player_mob_missing_key_or_lockpick");
   if(id==nullptr) {
     if(owner.version().game==1)
       owner.player()->playAnimByName("T_DONTKNOW", BS_NONE);
     return;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobMissingLockpick(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_missing_lockpick");
+  auto id = findSymbol("player_mob_missing_lockpick");
   if(id==nullptr) {
     if(owner.version().game==1)
       owner.player()->playAnimByName("T_DONTKNOW", BS_NONE);
     return;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::printMobTooFar(Npc& npc) {
-  auto id = vm.find_symbol_by_name("player_mob_too_far_away");
+  auto id = findSymbol("player_mob_too_far_away");
   if(id==nullptr) {
     owner.player()->playAnimByName("T_DONTKNOW", BS_NONE);
     return;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::invokeState(const std::shared_ptr<zenkit::INpc>& hnpc, const std::shared_ptr<zenkit::INpc>& oth, const char *name) {
-  auto id = vm.find_symbol_by_name(name);
+  PROFILE_SCOPE("script: state");
+  auto id = findSymbol(name);
   if(id==nullptr)
     return;
 
   ScopeVar self (*vm.global_self(),  hnpc);
   ScopeVar other(*vm.global_other(), oth);
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 int GameScript::invokeState(Npc* npc, Npc* oth, Npc* vic, ScriptFn fn) {
+  PROFILE_SCOPE("script: state");
   if(!fn.isValid())
     return 0;
   if(oth==nullptr){
@@ -1075,10 +1133,10 @@ int GameScript::invokeState(Npc* npc, Npc* oth, Npc* vic, ScriptFn fn) {
   auto* sym = vm.find_symbol_by_index(uint32_t(fn.ptr));
   int   ret = 0;
   if(sym!=nullptr && sym->rtype() == zenkit::DaedalusDataType::INT) {
-    ret = vm.call_function<int>(sym);
+    ret = callFunction<int>(sym);
     }
   else if(sym!=nullptr) {
-    vm.call_function<void>(sym);
+    callFunction<void>(sym);
     ret = 0;
     }
 
@@ -1093,6 +1151,7 @@ int GameScript::invokeState(Npc* npc, Npc* oth, Npc* vic, ScriptFn fn) {
   }
 
 void GameScript::invokeItem(Npc *npc, ScriptFn fn) {
+  PROFILE_SCOPE("script: item");
   if(fn==size_t(-1) || fn == 0)
     return;
   auto functionSymbol = vm.find_symbol_by_index(uint32_t(fn.ptr));
@@ -1101,35 +1160,36 @@ void GameScript::invokeItem(Npc *npc, ScriptFn fn) {
     return;
 
   ScopeVar self(*vm.global_self(), npc->handlePtr());
-  vm.call_function<void>(functionSymbol);
+  callFunction<void>(functionSymbol);
   }
 
 int GameScript::invokeMana(Npc &npc, Npc* target, int mana) {
-  auto fn = vm.find_symbol_by_name("Spell_ProcessMana");
+  auto fn = findSymbol("Spell_ProcessMana");
   if(fn==nullptr)
     return SpellCode::SPL_SENDSTOP;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), target != nullptr ? target->handlePtr() : nullptr);
 
-  return vm.call_function<int>(fn,mana);
+  return callFunction<int>(fn,mana);
   }
 
 int GameScript::invokeManaRelease(Npc &npc, Npc* target, int mana) {
-  auto fn = vm.find_symbol_by_name("Spell_ProcessMana_Release");
+  auto fn = findSymbol("Spell_ProcessMana_Release");
   if(fn==nullptr)
     return SpellCode::SPL_SENDSTOP;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), target != nullptr ? target->handlePtr() : nullptr);
 
-  return vm.call_function<int>(fn,mana);
+  return callFunction<int>(fn,mana);
   }
 
 void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
+  PROFILE_SCOPE("script: spell");
   auto&      tag = spellFxInstanceNames->get_string(uint16_t(it.spellId()));
   string_frm name("Spell_Cast_",tag);
-  auto       fn = vm.find_symbol_by_name(name);
+  auto       fn = findSymbol(name);
   if(fn==nullptr)
     return;
 
@@ -1140,9 +1200,9 @@ void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
   try {
     if(fn->count()==1) {
       // this is a leveled spell
-      vm.call_function<void>(fn, splLevel);
+      callFunction<void>(fn, splLevel);
       } else {
-      vm.call_function<void>(fn);
+      callFunction<void>(fn);
       }
     }
   catch(...) {
@@ -1151,28 +1211,29 @@ void GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
   }
 
 int GameScript::invokeCond(Npc& npc, std::string_view func) {
-  auto fn = vm.find_symbol_by_name(func);
+  PROFILE_SCOPE("script: condition");
+  auto fn = findSymbol(func);
   if(fn==nullptr) {
     Gothic::inst().onPrint("MOBSI::conditionFunc is not invalid");
     return 1;
     }
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  return vm.call_function<int>(fn);
+  return callFunction<int>(fn);
   }
 
 void GameScript::invokePickLock(Npc& npc, int bSuccess, int bBrokenOpen) {
-  auto fn   = vm.find_symbol_by_name("G_PickLock");
+  auto fn   = findSymbol("G_PickLock");
   if(fn==nullptr)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(fn, bSuccess, bBrokenOpen);
+  callFunction<void>(fn, bSuccess, bBrokenOpen);
   }
 
 void GameScript::invokeRefreshAtInsert(Npc& npc) {
   if(B_RefreshAtInsert==nullptr || owner.version().game!=2)
     return;
   ScopeVar self(*vm.global_self(), npc.handlePtr());
-  vm.call_function<void>(B_RefreshAtInsert);
+  callFunction<void>(B_RefreshAtInsert);
   }
 
 CollideMask GameScript::canNpcCollideWithSpell(Npc& npc, Npc* shooter, int32_t spellId) {
@@ -1183,13 +1244,13 @@ CollideMask GameScript::canNpcCollideWithSpell(Npc& npc, Npc* shooter, int32_t s
       return COLL_DONOTHING;
     }
 
-  auto fn   = vm.find_symbol_by_name("C_CanNpcCollideWithSpell");
+  auto fn   = findSymbol("C_CanNpcCollideWithSpell");
   if(fn==nullptr)
     return COLL_DOEVERYTHING;
 
   ScopeVar self (*vm.global_self(),  npc.handlePtr());
   ScopeVar other(*vm.global_other(), shooter->handlePtr());
-  return CollideMask(vm.call_function<int>(fn, spellId));
+  return CollideMask(callFunction<int>(fn, spellId));
   }
 
 // Gothic 1 only differentiates between the two worldmap types with and
@@ -1208,7 +1269,7 @@ int GameScript::playerHotKeyScreenMap_G1(Npc& pl) {
   }
 
 int GameScript::playerHotKeyScreenMap(Npc& pl) {
-  auto fn   = vm.find_symbol_by_name("player_hotkey_screen_map");
+  auto fn   = findSymbol("player_hotkey_screen_map");
   if(fn==nullptr) {
     if(owner.version().game==1)
       return playerHotKeyScreenMap_G1(pl);
@@ -1216,7 +1277,7 @@ int GameScript::playerHotKeyScreenMap(Npc& pl) {
     }
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  int map = vm.call_function<int>(fn);
+  int map = callFunction<int>(fn);
   if(map>=0)
     pl.useItem(size_t(map));
   return map;
@@ -1227,12 +1288,12 @@ void GameScript::playerHotLamePotion(Npc& pl) {
   if(opt==0)
     return;
 
-  auto fn   = vm.find_symbol_by_name("player_hotkey_lame_potion");
+  auto fn   = findSymbol("player_hotkey_lame_potion");
   if(fn==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  vm.call_function<void>(fn);
+  callFunction<void>(fn);
   }
 
 void GameScript::playerHotLameHeal(Npc& pl) {
@@ -1240,12 +1301,12 @@ void GameScript::playerHotLameHeal(Npc& pl) {
   if(opt==0)
     return;
 
-  auto fn   = vm.find_symbol_by_name("player_hotkey_lame_heal");
+  auto fn   = findSymbol("player_hotkey_lame_heal");
   if(fn==nullptr)
     return;
 
   ScopeVar self(*vm.global_self(), pl.handlePtr());
-  vm.call_function<void>(fn);
+  callFunction<void>(fn);
   }
 
 std::string_view GameScript::spellCastAnim(Npc&, Item &it) {
@@ -1327,24 +1388,24 @@ uint32_t GameScript::messageTime(std::string_view id) const {
   }
 
 void GameScript::printNothingToGet() {
-  auto id = vm.find_symbol_by_name("player_plunder_is_empty");
+  auto id = findSymbol("player_plunder_is_empty");
   if(id==nullptr) {
     if(owner.version().game==1)
       owner.player()->playAnimByName("T_DONTKNOW", BS_NONE);
     return;
     }
   ScopeVar self(*vm.global_self(), owner.player()->handlePtr());
-  vm.call_function<void>(id);
+  callFunction<void>(id);
   }
 
 void GameScript::useInteractive(const std::shared_ptr<zenkit::INpc>& hnpc, std::string_view func) {
-  auto fn = vm.find_symbol_by_name(func);
+  auto fn = findSymbol(func);
   if(fn == nullptr)
     return;
 
   ScopeVar self(*vm.global_self(),hnpc);
   try {
-    vm.call_function<void>(fn);
+    callFunction<void>(fn);
     }
   catch (...) {
     Log::i("unable to use interactive [",func,"]");
@@ -1438,7 +1499,7 @@ zenkit::DaedalusVm GameScript::createVm(Gothic& gothic) {
   }
 
 bool GameScript::hasSymbolName(std::string_view name) {
-  return vm.find_symbol_by_name(name)!=nullptr;
+  return findSymbol(name)!=nullptr;
   }
 
 uint64_t GameScript::tickCount() const {
@@ -1541,7 +1602,7 @@ void GameScript::removeItem(Item &it) {
   }
 
 void GameScript::setInstanceNPC(std::string_view name, Npc &npc) {
-  auto sym = vm.find_symbol_by_name(name);
+  auto sym = findSymbol(name);
   if(sym == nullptr) {
     Tempest::Log::e("Cannot set NPC instance ", name, ": Symbol not found.");
     return;
@@ -1564,7 +1625,7 @@ AiOuputPipe *GameScript::openDlgOuput(Npc &player, Npc &npc) {
   }
 
 ScriptFn GameScript::playerPercAssessMagic() {
-  auto id = vm.find_symbol_by_name("PLAYER_PERC_ASSESSMAGIC");
+  auto id = findSymbol("PLAYER_PERC_ASSESSMAGIC");
   if(id==nullptr)
     return ScriptFn();
 
@@ -1574,7 +1635,7 @@ ScriptFn GameScript::playerPercAssessMagic() {
   }
 
 int GameScript::npcDamDiveTime() {
-  auto id = vm.find_symbol_by_name("NPC_DAM_DIVE_TIME");
+  auto id = findSymbol("NPC_DAM_DIVE_TIME");
   if(id==nullptr)
     return 0;
   return id->get_int();
@@ -1669,7 +1730,7 @@ int GameScript::wld_getguildattitude(int gil1, int gil2) {
   }
 
 void GameScript::wld_exchangeguildattitudes(std::string_view name) {
-  auto guilds = vm.find_symbol_by_name(name);
+  auto guilds = findSymbol(name);
   if(guilds==nullptr)
     return;
   for(size_t i=0;i<gilTblSize;++i) {
@@ -2026,7 +2087,7 @@ void GameScript::npc_exchangeroutine(std::shared_ptr<zenkit::INpc> npcRef, std::
     auto& v = npc->handle();
     string_frm name("Rtn_",rname,'_',v.id);
 
-    auto* sym = vm.find_symbol_by_name(name);
+    auto* sym = findSymbol(name);
     size_t d = sym != nullptr ? sym->index() : 0;
     if(d>0)
       npc->excRoutine(d);
@@ -2496,8 +2557,9 @@ bool GameScript::npc_checkinfo(std::shared_ptr<zenkit::INpc> npcRef, int imp) {
 
   auto& pl  = hero->handle();
   auto& npc = n->handle();
-  for(auto& info:dialogsInfo) {
-    if(info->npc!=int32_t(npc.symbol_index()) || info->important!=imp)
+  for(auto id:npcDialogs(npc)) {
+    auto& info = dialogsInfo[id];
+    if(info->important!=imp)
       continue;
     bool npcKnowsInfo = doesNpcKnowInfo(pl,info->symbol_index());
     if(npcKnowsInfo && !info->permanent)
@@ -2506,7 +2568,7 @@ bool GameScript::npc_checkinfo(std::shared_ptr<zenkit::INpc> npcRef, int imp) {
     if(info->condition) {
       auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info->condition));
       if (conditionSymbol != nullptr)
-        valid = vm.call_function<int>(conditionSymbol)!=0;
+        valid = callFunction<int>(conditionSymbol)!=0;
       }
     if(valid) {
       return true;
@@ -3371,11 +3433,44 @@ void GameScript::sort(std::vector<GameScript::DlgChoice> &dlg) {
   }
 
 void GameScript::setNpcInfoKnown(const zenkit::INpc& npc, const zenkit::IInfo& info) {
-  auto id = std::make_pair(vm.find_symbol_by_instance(npc)->index(),vm.find_symbol_by_instance(info)->index());
-  dlgKnownInfos.insert(id);
+  setInfoKnown(npc.symbol_index(),info.symbol_index());
   }
 
 bool GameScript::doesNpcKnowInfo(const zenkit::INpc& npc, size_t infoInstance) const {
-  auto id = std::make_pair(vm.find_symbol_by_instance(npc)->index(),infoInstance);
-  return dlgKnownInfos.find(id)!=dlgKnownInfos.end();
+  auto id = dialogsId.find(infoInstance);
+  if(id==dialogsId.end())
+    return false;
+  auto bits = dlgKnownInfos.find(npc.symbol_index());
+  if(bits==dlgKnownInfos.end())
+    return false;
+  const size_t i = id->second;
+  return (bits->second[i/64] & (uint64_t(1) << (i%64)))!=0;
+  }
+
+void GameScript::setInfoKnown(size_t npcInstance, size_t infoInstance) {
+  auto id = dialogsId.find(infoInstance);
+  if(id==dialogsId.end())
+    return;
+  auto& bits = dlgKnownInfos[npcInstance];
+  bits.resize((dialogsInfo.size()+63)/64);
+  const size_t i = id->second;
+  bits[i/64] |= (uint64_t(1) << (i%64));
+  }
+
+std::vector<std::pair<size_t,size_t>> GameScript::knownInfos() const {
+  std::vector<std::pair<size_t,size_t>> ret;
+  for(auto& [npc,bits]:dlgKnownInfos) {
+    for(size_t i=0; i<bits.size()*64 && i<dialogsInfo.size(); ++i)
+      if((bits[i/64] & (uint64_t(1) << (i%64)))!=0)
+        ret.emplace_back(npc, dialogsInfo[i]->symbol_index());
+    }
+  return ret;
+  }
+
+const std::vector<uint32_t>& GameScript::npcDialogs(const zenkit::INpc& npc) const {
+  static const std::vector<uint32_t> empty;
+  auto it = dialogsByNpc.find(int32_t(npc.symbol_index()));
+  if(it==dialogsByNpc.end())
+    return empty;
+  return it->second;
   }
@@ -4,8 +4,10 @@
 #include <zenkit/addon/daedalus.hh>
 #include <zenkit/CutsceneLibrary.hh>
 
+#include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <random>
 
 #include <Tempest/Matrix4x4>
@@ -17,6 +19,7 @@
 #include "game/constants.h"
 #include "game/aistate.h"
 #include "game/questlog.h"
+#include "game/scriptprofiler.h"
 
 class GameSession;
 class World;
@@ -76,8 +79,21 @@ class GameScript final {
     void         loadPerc(Serialize& fin);
 
     inline auto& getVm() { return vm; }
+    auto&        scriptProfiler() { return profiler; }
     auto         questLog() const -> const QuestLog&;
 
+    template<class R = void, class... Args>
+    R callFunction(zenkit::DaedalusSymbol* fn, Args&&... args) {
+      ScriptProfiler::Scope scope(profiler, fn);
+      return vm.call_function<R>(fn, std::forward<Args>(args)...);
+      }
+    template<class R = void, class... Args>
+    R callFunction(std::string_view name, Args&&... args) {
+      if(auto fn = findSymbol(name))
+        return callFunction<R>(fn, std::forward<Args>(args)...);
+      return vm.call_function<R>(name, std::forward<Args>(args)...);
+      }
+
     const World& world() const;
     World&       world();
     uint64_t     tickCount() const;
@@ -197,10 +213,14 @@ class GameScript final {
     template <class F>
     void bindExternal(const std::string& name, F function) {
       vm.register_external(name, std::function<typename DetermineSignature<F>::signature> (
-                                   [this, function](auto ... v) { return (this->*function)(v...); }));
+                                   [this, function, sym = findSymbol(name)](auto ... v) {
+                                     ScriptProfiler::Scope scope(profiler, sym, true);
+                                     return (this->*function)(v...);
+                                     }));
       }
 
     void  initCommon();
+    void  initSymbolCache();
     void  initSettings();
     void  loadDialogOU();
 
@@ -443,6 +463,9 @@ class GameScript final {
     void sort(std::vector<DlgChoice>& dlg);
     void setNpcInfoKnown(const zenkit::INpc& npc, const zenkit::IInfo& info);
     bool doesNpcKnowInfo(const zenkit::INpc& npc, size_t infoInstance) const;
+    void setInfoKnown(size_t npcInstance, size_t infoInstance);
+    auto knownInfos() const -> std::vector<std::pair<size_t,size_t>>;
+    auto npcDialogs(const zenkit::INpc& npc) const -> const std::vector<uint32_t>&;
 
     void saveSym(Serialize& fout, zenkit::DaedalusSymbol& s);
 
@@ -451,6 +474,14 @@ class GameScript final {
 
     GameSession&                                                owner;
     zenkit::DaedalusVm                                          vm;
+    ScriptProfiler                                              profiler;
+
+    struct SymbolHash {
+      using is_transparent = void;
+      size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+      };
+    // name, as spelled by engine -> symbol; zenkit upper-cases and allocates on every find_symbol_by_name
+    std::unordered_map<std::string,zenkit::DaedalusSymbol*,SymbolHash,std::equal_to<>> symbolCache;
     int32_t                                                     vmLang = -1;
     std::mt19937                                                randGen;
 
@@ -460,8 +491,10 @@ class GameScript final {
     std::unique_ptr<SvmDefinitions>                             svm;
     uint64_t                                                    svmBarrier=0;
 
-    std::set<std::pair<size_t,size_t>>                          dlgKnownInfos;
     std::vector<std::shared_ptr<zenkit::IInfo>>                 dialogsInfo;
+    std::unordered_map<int32_t,std::vector<uint32_t>>           dialogsByNpc;  // npc symbol -> id in dialogsInfo
+    std::unordered_map<size_t,uint32_t>                         dialogsId;     // info symbol -> id in dialogsInfo
+    std::map<size_t,std::vector<uint64_t>>                      dlgKnownInfos; // npc symbol -> bitset of known dialogsInfo
     zenkit::CutsceneLibrary                                     dialogs;
     std::unordered_map<size_t,AiState>                          aiStates;
     std::unique_ptr<AiOuputPipe>                                aiDefaultPipe;
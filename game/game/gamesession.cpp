@@ -1,9 +1,11 @@
 #include "gamesession.h"
 #include "savegameheader.h"
 
+#include <Tempest/Application>
 #include <Tempest/Log>
 #include <Tempest/MemReader>
 #include <Tempest/MemWriter>
+#include <algorithm>
 #include <cctype>
 
 #include "utils/string_frm.h"
@@ -20,6 +22,7 @@ using namespace Tempest;
 // rate 14.5 to 1
 const uint64_t GameSession::multTime=14500;
 const uint64_t GameSession::divTime =1000;
+const uint32_t GameSession::maxSimSteps=4;
 
 void GameSession::HeroStorage::save(Npc& npc) {
   storage.clear();
@@ -67,6 +70,7 @@ void GameSession::HeroStorage::putToWorld(World& owner, std::string_view wayPoin
 
 
 GameSession::GameSession(std::string file) {
+  const uint64_t t0 = Application::tickCount();
   cam.reset(new Camera());
 
   Gothic::inst().setLoadingProgress(0);
@@ -74,6 +78,7 @@ GameSession::GameSession(std::string file) {
   setTime(gtime(8,0));
 
   vm.reset(new GameScript(*this));
+  const uint64_t t1 = Application::tickCount();
   initPerceptions();
 
   setWorld(std::unique_ptr<World>(new World(*this,std::move(file),true,[&](int v){
@@ -111,6 +116,7 @@ GameSession::GameSession(std::string file) {
   Gothic::inst().setLoadingProgress(96);
   ticks = 1;
   // wrld->setDayTime(8,0);
+  Log::i("new game: script = ",t1-t0," ms, total = ",Application::tickCount()-t0," ms");
   }
 
 GameSession::GameSession(Serialize &fin) {
@@ -136,9 +142,11 @@ GameSession::GameSession(Serialize &fin) {
   fin.setEntry("game/session");
   fin.read(ticks,wrldTime,wrldTimePart,wname);
 
+  const uint64_t t0 = Application::tickCount();
   cam.reset(new Camera());
   vm.reset(new GameScript(*this));
   vm->initDialogs();
+  const uint64_t t1 = Application::tickCount();
 
   if(true) {
     setWorld(std::unique_ptr<World>(new World(*this,wname,false,[&](int v){
@@ -165,6 +173,7 @@ GameSession::GameSession(Serialize &fin) {
   fin.setEntry("game/camera");
   cam->load(fin,wrld->player());
   Gothic::inst().setLoadingProgress(96);
+  Log::i("load game: script = ",t1-t0," ms, total = ",Application::tickCount()-t0," ms");
   }
 
 GameSession::~GameSession() {
@@ -228,6 +237,11 @@ void GameSession::setupSettings() {
 
   const float soundVolume = Gothic::inst().settingsGetF("SOUND","soundVolume");
   sound.setGlobalVolume(soundVolume*soundScale);
+
+  const int rate = Gothic::settingsGetI("GAME","simulationRate");
+  simRate      = rate>0 ? uint64_t(std::min(rate,200)) : 0;
+  simAccum     = 0;
+  simStepFract = 0;
   }
 
 void GameSession::setWorld(std::unique_ptr<World> &&w) {
@@ -309,15 +323,27 @@ void GameSession::tick(uint64_t dt) {
   timeMulFract = dt%1000;
   dt /= 1000;
 
-  ticks+=dt;
-
-  uint64_t add = dt*multTime + wrldTimePart;
-  wrldTimePart = add%divTime;
-  wrldTime.addMilis(add/divTime);
-
-  vm->tick(dt);
-  wrld->tick(dt);
-  // std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  if(simRate==0) {
+    implTick(dt);
+    } else {
+    // fixed-step simulation: rendering runs at full rate, game logic at 'simulationRate'
+    // visual side catches up by interpolation, see tickAlpha()
+    simAccum += dt;
+    for(uint32_t i=0; simAccum>=simStep(); ++i) {
+      if(i==maxSimSteps) {
+        // too slow to keep up - drop the time, instead of spiraling down
+        simAccum = 0;
+        break;
+        }
+      const uint64_t step = simStep();
+      // 1000/rate is not integer in general: carry remainder, so steps average to exact rate (16,17,17 for 60Hz)
+      simStepFract = (1000+simStepFract)%simRate;
+      simAccum    -= step;
+      implTick(step);
+      if(exitSessionFlg || !chWorld.zen.empty())
+        break;
+      }
+    }
 
   if(exitSessionFlg) {
     exitSessionFlg = false;
@@ -353,6 +379,28 @@ void GameSession::tick(uint64_t dt) {
     }
   }
 
+void GameSession::implTick(uint64_t dt) {
+  ticks+=dt;
+
+  uint64_t add = dt*multTime + wrldTimePart;
+  wrldTimePart = add%divTime;
+  wrldTime.addMilis(add/divTime);
+
+  vm->tick(dt);
+  wrld->tick(dt);
+  // std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  }
+
+float GameSession::tickAlpha() const {
+  if(simRate==0)
+    return 1.f;
+  return std::min(float(simAccum)/float(simStep()), 1.f);
+  }
+
+uint64_t GameSession::simStep() const {
+  return (1000+simStepFract)/simRate;
+  }
+
 void GameSession::setTimeMultiplyer(float t) {
   timeMul = uint64_t(t*1000);
   }
@@ -480,7 +528,7 @@ bool GameSession::isWorldKnown(std::string_view name) const {
 void GameSession::initPerceptions() {
   // NOTE: world is null at this point and most scrip-api will be prone to crash
   if(vm->hasSymbolName("initPerceptions"))
-    vm->getVm().call_function("initPerceptions");
+    vm->callFunction("initPerceptions");
   }
 
 void GameSession::initScripts(bool firstTime) {
@@ -490,19 +538,19 @@ void GameSession::initScripts(bool firstTime) {
 
   if(firstTime) {
     if(vm->hasSymbolName("startup_global"))
-      vm->getVm().call_function("startup_global");
+      vm->callFunction("startup_global");
 
     string_frm startup("startup_", name);
     if(vm->hasSymbolName(startup))
-      vm->getVm().call_function(startup);
+      vm->callFunction(startup);
     }
 
   if(vm->hasSymbolName("init_global"))
-    vm->getVm().call_function("init_global");
+    vm->callFunction("init_global");
 
   string_frm init("init_",name);
   if(vm->hasSymbolName(init))
-    vm->getVm().call_function(init);
+    vm->callFunction(init);
 
   wrld->resetPositionToTA();
   }
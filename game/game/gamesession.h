@@ -57,6 +57,8 @@ class GameSession final {
     void         setTime(gtime t);
     void         tick(uint64_t dt);
     uint64_t     tickCount() const { return ticks; }
+    uint64_t     renderTickCount() const { return ticks+simAccum; }
+    float        tickAlpha() const;
 
     void         setTimeMultiplyer(float t);
 
@@ -90,6 +92,8 @@ class GameSession final {
     void         initScripts(bool firstTime);
     auto         implChangeWorld(std::unique_ptr<GameSession> &&game, std::string_view world, std::string_view wayPoint) -> std::unique_ptr<GameSession>;
     auto         findStorage(std::string_view name) -> const WorldStateStorage&;
+    void         implTick(uint64_t dt);
+    uint64_t     simStep() const;
 
     Tempest::SoundDevice           sound;
 
@@ -99,6 +103,7 @@ class GameSession final {
 
     uint64_t                       ticks = 0, wrldTimePart = 0;
     uint64_t                       timeMul = 1000, timeMulFract = 0;
+    uint64_t                       simRate = 0, simAccum = 0, simStepFract = 0;
     gtime                          wrldTime;
 
     std::vector<WorldStateStorage> visitedWorlds;
@@ -108,4 +113,5 @@ class GameSession final {
 
     static const uint64_t          multTime;
     static const uint64_t          divTime;
+    static const uint32_t          maxSimSteps;
   };
@@ -97,6 +97,8 @@ void Inventory::implLoad(Npc* owner, World& world, Serialize &s) {
   s.read(sz);
   for(size_t i=0;i<sz;++i)
     items.emplace_back(std::make_unique<Item>(world,s,Item::T_Inventory));
+  sorted = false;
+  rebuildIndex();
 
   s.read(sz);
   mdlSlots.resize(sz);
@@ -193,16 +195,14 @@ Inventory::Iterator Inventory::iterator(IteratorType t) const {
   }
 
 int32_t Inventory::priceOf(size_t cls) const {
-  for(auto& i:items)
-    if(i->clsId()==cls)
-      return i->cost();
+  if(auto it = findByClass(cls))
+    return it->cost();
   return 0;
   }
 
 int32_t Inventory::sellPriceOf(size_t cls) const {
-  for(auto& i:items)
-    if(i->clsId()==cls)
-      return i->sellCost();
+  if(auto it = findByClass(cls))
+    return it->sellCost();
   return 0;
   }
 
@@ -214,24 +214,21 @@ size_t Inventory::goldCount() const {
   }
 
 size_t Inventory::itemCount(const size_t cls) const {
-  for(auto& i:items)
-    if(i->clsId()==cls)
-      return i->count();
+  if(auto it = findByClass(cls))
+    return it->count();
   return 0;
   }
 
 Item* Inventory::addItem(std::unique_ptr<Item> &&p) {
   if(p==nullptr)
     return nullptr;
-  sorted=false;
 
   const auto cls = p->clsId();
   p->clearView();
   Item* it=findByClass(cls);
   if(it==nullptr) {
     p->clearView();
-    items.emplace_back(std::move(p));
-    return items.back().get();
+    return implInsert(std::move(p));
     } else {
     it->setCount(it->count()+p->count());
     it->handle().owner       = p->handle().owner;
@@ -251,15 +248,13 @@ Item* Inventory::addItem(std::string_view name, size_t count, World &owner) {
 Item* Inventory::addItem(size_t itemSymbol, size_t count, World &owner) {
   if(count<=0)
     return nullptr;
-  sorted=false;
 
   Item* it=findByClass(itemSymbol);
   if(it==nullptr) {
     try {
       std::unique_ptr<Item> ptr{new Item(owner,itemSymbol,Item::T_Inventory)};
       ptr->setCount(count);
-      items.emplace_back(std::move(ptr));
-      return items.back().get();
+      return implInsert(std::move(ptr));
       }
     catch(const std::runtime_error& call) {
       Log::e("[invalid call in VM, while initializing item: ",itemSymbol,"]");
@@ -300,41 +295,30 @@ void Inventory::delItem(Item *it, size_t count, Npc& owner) {
       } else {
       ++i;
       }
-  sorted=false;
 
-  for(size_t i=0;i<items.size();++i)
-    if(items[i]->clsId()==it->clsId()){
-      items.erase(items.begin()+int(i));
-      break;
-      }
+  implTake(it);
   }
 
 void Inventory::transfer(Inventory &to, Inventory &from, Npc* fromNpc, size_t itemSymbol, size_t count, World &wrld) {
-  for(size_t i=0;i<from.items.size();++i){
-    auto& it = *from.items[i];
-    if(it.clsId()!=itemSymbol)
-      continue;
-
-    from.sorted = false;
-    to.sorted   = false;
+  Item* it = from.findByClass(itemSymbol);
+  if(it==nullptr)
+    return;
 
-    if(count>it.count())
-      count=it.count();
+  if(count>it->count())
+    count=it->count();
 
-    if(it.count()==count) {
-      if(it.isEquipped()) {
-        if(fromNpc==nullptr){
-          Log::e("Inventory: invalid transfer call");
-          return; // error
-          }
-        from.unequip(&it,*fromNpc);
+  if(it->count()==count) {
+    if(it->isEquipped()) {
+      if(fromNpc==nullptr){
+        Log::e("Inventory: invalid transfer call");
+        return; // error
         }
-      to.addItem(std::move(from.items[i]));
-      from.items.erase(from.items.begin()+int(i));
-      } else {
-      it.setCount(it.count()-count);
-      to.addItem(itemSymbol,count,wrld);
+      from.unequip(it,*fromNpc);
       }
+    to.addItem(from.implTake(it));
+    } else {
+    it->setCount(it->count()-count);
+    to.addItem(itemSymbol,count,wrld);
     }
   }
 
@@ -568,6 +552,7 @@ void Inventory::clear(GameScript&, Npc&, bool includeMissionItm) {
       used.emplace_back(std::move(i));
       }
   items = std::move(used); // Gothic don't clear items, which are in use
+  rebuildIndex();
   }
 
 void Inventory::clear(GameScript& vm, Interactive& owner, bool includeMissionItm) {
@@ -577,6 +562,7 @@ void Inventory::clear(GameScript& vm, Interactive& owner, bool includeMissionItm
       used.emplace_back(std::move(i));
       }
   items = std::move(used); // Gothic don't clear items, which are in use
+  rebuildIndex();
   }
 
 bool Inventory::hasSpell(int32_t splId) const {
@@ -604,9 +590,8 @@ bool Inventory::hasRangedWeaponWithAmmo() const {
   for(auto& i:items) {
     uint32_t cls = uint32_t(i->handle().munition);
     if(cls>0 && cls!=munition) {
-      for(auto& it:items)
-        if(it->clsId()==cls)
-          return true;
+      if(findByClass(cls)!=nullptr)
+        return true;
       munition = cls;
       }
     }
@@ -958,11 +943,50 @@ void Inventory::equipBestArmor(Npc &owner) {
     setSlot(armor,a,owner,false);
   }
 
-Item *Inventory::findByClass(size_t cls) {
+Item *Inventory::findByClass(size_t cls) const {
+  auto it = byClass.find(cls);
+  if(it==byClass.end())
+    return nullptr;
+  return it->second;
+  }
+
+Item* Inventory::implInsert(std::unique_ptr<Item>&& p) {
+  Item* ret = p.get();
+  byClass[ret->clsId()] = ret;
+  bestCache.clear();
+
+  if(!sorted) {
+    items.emplace_back(std::move(p));
+    return ret;
+    }
+  // keep order, so iterator doesn't need to sort whole inventory again
+  auto at = std::upper_bound(items.begin(), items.end(), p, [](const std::unique_ptr<Item>& l, const std::unique_ptr<Item>& r){
+    return less(*l,*r);
+    });
+  items.insert(at, std::move(p));
+  return ret;
+  }
+
+std::unique_ptr<Item> Inventory::implTake(Item* it) {
+  auto at = std::find_if(items.begin(), items.end(), [it](const std::unique_ptr<Item>& i){
+    return i.get()==it;
+    });
+  if(at==items.end())
+    return nullptr;
+
+  std::unique_ptr<Item> ret = std::move(*at);
+  items.erase(at);
+  byClass.erase(ret->clsId());
+  bestCache.clear();
+  return ret;
+  }
+
+void Inventory::rebuildIndex() {
+  byClass.clear();
+  byClass.reserve(items.size());
   for(auto& i:items)
-    if(i->clsId()==cls)
-      return i.get();
-  return nullptr;
+    byClass[i->clsId()] = i.get();
+  bestCache.clear();
   }
 
 // Find the Nth item with a specific flag
@@ -984,26 +1008,36 @@ Item* Inventory::findByFlags(ItmFlags f, uint32_t num) const {
   }
 
 Item* Inventory::bestItem(Npc &owner, ItmFlags f) {
-  Item*   ret    = nullptr;
-  int32_t value  = std::numeric_limits<int32_t>::min();
-  int32_t damage = std::numeric_limits<int32_t>::min();
+  // candidates depend only on inventory content; checkCond depends on npc attributes, so it's never cached
+  for(auto i:bestCandidates(f)) {
+    if(i->checkCond(owner))
+      return i;
+    }
+  return nullptr;
+  }
+
+const std::vector<Item*>& Inventory::bestCandidates(ItmFlags f) {
+  for(auto& i:bestCache)
+    if(i.flag==f)
+      return i.items;
+
+  bestCache.emplace_back();
+  auto& c = bestCache.back();
+  c.flag = f;
   for(auto& i:items) {
     auto& itData = i->handle();
     auto  flag   = ItmFlags(itData.main_flag);
     if((flag & f)==0)
       continue;
-    if(!i->checkCond(owner))
-      continue;
     if(itData.munition>0 && findByClass(size_t(itData.munition))==nullptr)
       continue;
-
-    if(std::make_tuple(itData.damage_total, itData.value)>std::make_tuple(damage, value)){
-      ret    = i.get();
-      damage = itData.damage_total;
-      value  = itData.value;
-      }
+    c.items.push_back(i.get());
     }
-  return ret;
+  std::stable_sort(c.items.begin(), c.items.end(), [](const Item* l, const Item* r){
+    return std::make_tuple(l->handle().damage_total, l->handle().value) >
+           std::make_tuple(r->handle().damage_total, r->handle().value);
+    });
+  return c.items;
   }
 
 Item *Inventory::bestArmor(Npc &owner) {
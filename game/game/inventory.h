@@ -4,6 +4,7 @@
 #include <memory>
 #include <string_view>
 #include <string>
+#include <unordered_map>
 
 #include "game/constants.h"
 
@@ -137,11 +138,15 @@ class Inventory final {
     bool   equipNumSlot(Item *next, uint8_t slotHint, Npc &owner, bool force);
     void   applyArmor  (Item& it, Npc &owner, int32_t sgn);
 
-    Item*  findByClass(size_t cls);
+    Item*  findByClass(size_t cls) const;
+    Item*  implInsert (std::unique_ptr<Item>&& it);
+    auto   implTake   (Item* it) -> std::unique_ptr<Item>;
+    void   rebuildIndex();
     void   delItem    (Item* it, size_t count, Npc& owner);
     void   invalidateCond(Item*& slot,  Npc &owner);
 
     Item*  bestItem       (Npc &owner, ItmFlags f);
+    auto   bestCandidates (ItmFlags f) -> const std::vector<Item*>&;
     Item*  bestArmor      (Npc &owner);
     Item*  bestMeleeWeapon(Npc &owner);
     Item*  bestRangedWeapon(Npc &owner);
@@ -153,8 +158,15 @@ class Inventory final {
     static int  orderId(const Item& l);
     uint8_t     slotId (Item*& slt) const;
 
+    struct BestCache final {
+      ItmFlags           flag = ItmFlags(0);
+      std::vector<Item*> items; // best first, without checkCond
+      };
+
     mutable std::vector<std::unique_ptr<Item>> items;
     mutable bool                               sorted=false;
+    std::unordered_map<size_t,Item*>           byClass;
+    std::vector<BestCache>                     bestCache; // cleared on every change of item set
 
     uint32_t                           indexOf(const Item* it) const;
     Item*                              readPtr(Serialize& fin);
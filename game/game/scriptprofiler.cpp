@@ -0,0 +1,175 @@
+#include "scriptprofiler.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+using namespace Tempest;
+
+ScriptProfiler::ScriptProfiler(zenkit::DaedalusVm& vm)
+  :vm(vm) {
+  reset();
+  }
+
+void ScriptProfiler::setEnabled(bool e) {
+  if(enabled==e)
+    return;
+  enabled = e;
+  // frames that are open right now can't be closed consistently anymore
+  stack.clear();
+  generation++;
+  }
+
+void ScriptProfiler::reset() {
+  nodes.clear();
+  edges.clear();
+  stack.clear();
+  nodes.emplace_back(); // root
+  generation++;
+  }
+
+uint64_t ScriptProfiler::now() {
+  auto dt = std::chrono::steady_clock::now().time_since_epoch();
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count());
+  }
+
+size_t ScriptProfiler::enter(const zenkit::DaedalusSymbol& fn, bool external) {
+  const size_t depth = stack.size();
+  if(external) {
+    // externals are called from script code, that engine never entered explicitly
+    const uint32_t caller = functionAt(vm.pc());
+    const uint32_t top    = stack.empty() ? nil : nodes[stack.back().node].sym;
+    if(caller!=nil && caller!=top)
+      push(caller,false,false);
+    }
+  push(fn.index(),external,true);
+  return depth;
+  }
+
+void ScriptProfiler::leave(uint32_t gen, size_t depth) {
+  if(gen!=generation)
+    return;
+  const uint64_t t = now();
+  while(stack.size()>depth) {
+    auto  f  = stack.back();
+    auto& n  = nodes[f.node];
+    auto  dt = t-f.begin;
+    n.timeNs += dt;
+    if(n.parent!=nil)
+      nodes[n.parent].childNs += dt;
+    stack.pop_back();
+    }
+  }
+
+void ScriptProfiler::push(uint32_t sym, bool external, bool call) {
+  const uint32_t parent = stack.empty() ? 0 : stack.back().node;
+  const uint64_t key    = (uint64_t(parent) << 32) | sym;
+
+  auto it = edges.find(key);
+  if(it==edges.end()) {
+    Node n;
+    n.sym      = sym;
+    n.parent   = parent;
+    n.external = external;
+    nodes.push_back(n);
+    it = edges.emplace(key, uint32_t(nodes.size()-1)).first;
+    }
+
+  if(call)
+    nodes[it->second].calls++;
+  stack.push_back(Frame{it->second, now()});
+  }
+
+uint32_t ScriptProfiler::functionAt(uint32_t pc) {
+  if(code.empty()) {
+    for(auto& s:vm.symbols()) {
+      if(!s.is_const() || s.is_member() || s.is_external())
+        continue;
+      const auto t = s.type();
+      if(t!=zenkit::DaedalusDataType::FUNCTION && t!=zenkit::DaedalusDataType::PROTOTYPE &&
+         t!=zenkit::DaedalusDataType::INSTANCE)
+        continue;
+      code.emplace_back(s.address(), s.index());
+      }
+    std::sort(code.begin(), code.end());
+    }
+
+  auto it = std::upper_bound(code.begin(), code.end(), std::make_pair(pc, nil));
+  if(it==code.begin())
+    return nil;
+  return std::prev(it)->second;
+  }
+
+std::string_view ScriptProfiler::symbolName(uint32_t sym) const {
+  if(auto s = vm.find_symbol_by_index(sym))
+    return s->name();
+  return "?";
+  }
+
+std::vector<ScriptProfiler::Stat> ScriptProfiler::hotFunctions() const {
+  std::unordered_map<uint32_t,Stat> acc;
+  for(size_t i=1; i<nodes.size(); ++i) {
+    auto& n = nodes[i];
+    auto& s = acc[n.sym];
+    s.name         = symbolName(n.sym);
+    s.external     = s.external || n.external;
+    s.calls       += n.calls;
+    s.exclusiveNs += n.timeNs>n.childNs ? n.timeNs-n.childNs : 0;
+
+    // recursive calls: count inclusive time only on outermost frame
+    bool outer = true;
+    for(uint32_t p=n.parent; p!=nil && p!=0; p=nodes[p].parent) {
+      if(nodes[p].sym==n.sym) {
+        outer = false;
+        break;
+        }
+      }
+    if(outer)
+      s.inclusiveNs += n.timeNs;
+    }
+
+  std::vector<Stat> ret;
+  ret.reserve(acc.size());
+  for(auto& i:acc)
+    ret.push_back(i.second);
+  std::sort(ret.begin(), ret.end(), [](const Stat& a, const Stat& b){
+    return a.exclusiveNs>b.exclusiveNs;
+    });
+  return ret;
+  }
+
+bool ScriptProfiler::dumpFolded(std::string_view path) const {
+  // folded stacks, as consumed by flamegraph.pl/speedscope: "a;b;c <self time in ns>"
+  std::stringstream             s;
+  std::vector<std::string_view> names;
+  for(size_t i=1; i<nodes.size(); ++i) {
+    auto& n    = nodes[i];
+    auto  self = n.timeNs>n.childNs ? n.timeNs-n.childNs : 0;
+    if(self==0)
+      continue;
+    names.clear();
+    for(uint32_t p=uint32_t(i); p!=nil && p!=0; p=nodes[p].parent)
+      names.push_back(symbolName(nodes[p].sym));
+    for(size_t r=names.size(); r>0; --r) {
+      s << names[r-1];
+      if(r>1)
+        s << ";";
+      }
+    s << " " << self << "\n";
+    }
+
+  try {
+    auto str = s.str();
+    WFile f(std::string(path).c_str());
+    f.write(str.data(),str.size());
+    f.flush();
+    }
+  catch(...) {
+    Log::e("unable to write script profile: \"",path,"\"");
+    return false;
+    }
+  return true;
+  }
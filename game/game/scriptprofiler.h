@@ -0,0 +1,89 @@
+#pragma once
+
+#include <zenkit/DaedalusVm.hh>
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Instrumenting profiler for Daedalus scripts. Engine->script calls (GameScript::callFunction, triggers, frame-functions)
+// and script->engine calls (externals) are timed as a call tree; collection is enabled at runtime
+// via console ("toggle script profiler").
+// Script functions called from other script code are not seen by the engine - they show up only as caller of an external,
+// resolved from vm.pc(), carrying time of those externals.
+class ScriptProfiler final {
+  public:
+    explicit ScriptProfiler(zenkit::DaedalusVm& vm);
+
+    struct Stat {
+      std::string_view name;
+      bool             external    = false;
+      uint64_t         calls       = 0;
+      uint64_t         inclusiveNs = 0;
+      uint64_t         exclusiveNs = 0;
+      };
+
+    class Scope final {
+      public:
+        Scope(ScriptProfiler& p, const zenkit::DaedalusSymbol* fn, bool external = false) {
+          if(!p.enabled || fn==nullptr)
+            return;
+          owner = &p;
+          gen   = p.generation;
+          depth = p.enter(*fn, external);
+          }
+        ~Scope() {
+          if(owner!=nullptr)
+            owner->leave(gen, depth);
+          }
+        Scope(const Scope&) = delete;
+        Scope& operator = (const Scope&) = delete;
+
+      private:
+        ScriptProfiler* owner = nullptr;
+        uint32_t        gen   = 0;
+        size_t          depth = 0;
+      };
+
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool e);
+    void reset();
+
+    auto hotFunctions() const -> std::vector<Stat>;
+    bool dumpFolded(std::string_view path) const;
+
+  private:
+    static constexpr uint32_t nil = uint32_t(-1);
+
+    struct Node {
+      uint32_t sym      = nil;
+      uint32_t parent   = nil;
+      bool     external = false;
+      uint64_t calls    = 0;
+      uint64_t timeNs   = 0;
+      uint64_t childNs  = 0;
+      };
+
+    struct Frame {
+      uint32_t node  = 0;
+      uint64_t begin = 0;
+      };
+
+    static uint64_t now();
+
+    size_t   enter(const zenkit::DaedalusSymbol& fn, bool external);
+    void     leave(uint32_t gen, size_t depth);
+    void     push(uint32_t sym, bool external, bool call);
+    uint32_t functionAt(uint32_t pc);
+    auto     symbolName(uint32_t sym) const -> std::string_view;
+
+    zenkit::DaedalusVm&                          vm;
+    bool                                         enabled    = false;
+    uint32_t                                     generation = 0;
+
+    std::vector<Node>                            nodes;
+    std::unordered_map<uint64_t,uint32_t>        edges; // (parent node, symbol) -> node
+    std::vector<Frame>                           stack;
+    std::vector<std::pair<uint32_t,uint32_t>>    code;  // (address, symbol) sorted by address
+  };
@@ -3,6 +3,7 @@
 #include <Tempest/Log>
 #include <Tempest/TextCodec>
 
+#include <cstdlib>
 #include <cstring>
 #include <cctype>
 #include <cassert>
@@ -30,7 +31,15 @@ using namespace FileUtil;
 
 Gothic* Gothic::instance = nullptr;
 
+static bool hasRayQuery() {
+  if(Resources::isHeadless())
+    return false;
+  return Resources::device().properties().raytracing.rayQuery;
+  }
+
 static bool hasMeshShader() {
+  if(Resources::isHeadless())
+    return false;
   const auto& p = Resources::device().properties();
   if(p.meshlets.meshShader && p.meshlets.taskShader)
     return true;
@@ -38,6 +47,8 @@ static bool hasMeshShader() {
   }
 
 static bool hasBindless() {
+  if(Resources::isHeadless())
+    return false;
   const auto& p = Resources::device().properties();
   if(p.descriptors.nonUniformIndexing && p.descriptors.maxTexture>=65000 && p.descriptors.maxStorage>=65000)
     return true;
@@ -78,8 +89,7 @@ Gothic::Gothic() {
 #endif
   setBenchmarkMode(CommandLine::inst().isBenchmarkMode());
 
-  auto& gpu = Resources::device().properties();
-  if(gpu.raytracing.rayQuery) {
+  if(hasRayQuery()) {
     opts.doRayQuery = CommandLine::inst().isRayQuery();
     opts.doRtGi     = opts.doRayQuery && CommandLine::inst().isRtGi();
     }
@@ -120,6 +130,7 @@ Gothic::Gothic() {
   defaults->set("GAME", "useGothic1Controls",  1);
   defaults->set("GAME", "highlightMeleeFocus", 0);
   defaults->set("GAME", "useQuickSaveKeys",    1);
+  defaults->set("GAME", "simulationRate",      60);
 
   // switch related language options
   defaults->set("GAME", "language", -1);
@@ -151,6 +162,10 @@ Gothic::Gothic() {
   defaults->set("ENGINE", "zWindEnabled",       1);
   defaults->set("ENGINE", "zWindCycleTime",     4);
   defaults->set("ENGINE", "zWindCycleTimeVar",  6);
+  defaults->set("ENGINE", "pfxLod",             1);
+  defaults->set("ENGINE", "pfxLodScreenSize",   48);  // pixels, below that emitter is updated at reduced rate
+  defaults->set("ENGINE", "pfxLodUpdateTime",   50);  // ms, update interval at reduced rate
+  defaults->set("ENGINE", "pfxLodPpsScale",     0.5f);
 
   defaults->set("KEYS", "keyEnd",         "0100");
   defaults->set("KEYS", "keyHeal",        "2300");
@@ -236,6 +251,7 @@ Gothic::Gothic() {
   }
 
 Gothic::~Gothic() {
+  stopPrewarmSoundFx();
   instance = nullptr;
   }
 
@@ -245,6 +261,7 @@ Gothic& Gothic::inst() {
   }
 
 void Gothic::setupGlobalScripts() {
+  stopPrewarmSoundFx();
   fight      .reset(new FightAi());
   camDef     .reset(new CameraDefinitions());
   soundDef   .reset(new SoundDefinitions());
@@ -339,13 +356,18 @@ SoundFx *Gothic::loadSoundFx(std::string_view name) {
 
   auto cname = std::string(name);
 
+  {
   std::lock_guard<std::mutex> guard(syncSnd);
   auto it=sndFxCache.find(cname);
   if(it!=sndFxCache.end())
     return &it->second;
+  }
 
   try {
-    auto ret = sndFxCache.emplace(name,SoundFx(name));
+    // decode without lock, so other lookups are not blocked; first inserted instance wins
+    auto fx = SoundFx(name);
+    std::lock_guard<std::mutex> guard(syncSnd);
+    auto ret = sndFxCache.emplace(name,std::move(fx));
     return &ret.first->second;
     }
   catch(...) {
@@ -354,16 +376,45 @@ SoundFx *Gothic::loadSoundFx(std::string_view name) {
     }
   }
 
+void Gothic::prewarmSoundFx() {
+  stopPrewarmSoundFx();
+  // footsteps, swings and hits of loaded animations: decode ahead of first use, instead of on game thread
+  auto names = Resources::animationSfx();
+  sndPrewarm = std::thread([this,names=std::move(names)]() {
+    Workers::setThreadName("Sound prewarm");
+    size_t count = 0;
+    for(auto& i:names) {
+      // leave half of the cache to sounds, that are actually played
+      if(sndPrewarmStop.load() || Resources::soundCacheSize()>Resources::soundCacheBudget()/2)
+        break;
+      loadSoundFx(i);
+      ++count;
+      }
+    Log::i("sound prewarm: ",count," of ",names.size()," animation sfx");
+    });
+  }
+
+void Gothic::stopPrewarmSoundFx() {
+  if(!sndPrewarm.joinable())
+    return;
+  sndPrewarmStop.store(true);
+  sndPrewarm.join();
+  sndPrewarmStop.store(false);
+  }
+
 SoundFx *Gothic::loadSoundWavFx(std::string_view name) {
-  auto snd   = Resources::loadSoundBuffer(name);
   auto cname = std::string(name);
 
+  {
   std::lock_guard<std::mutex> guard(syncSnd);
   auto it=sndWavCache.find(cname);
   if(it!=sndWavCache.end())
     return &it->second;
+  }
 
   try {
+    auto snd = Resources::loadSoundBuffer(name);
+    std::lock_guard<std::mutex> guard(syncSnd);
     auto ret = sndWavCache.emplace(name,SoundFx(std::move(snd)));
     return &ret.first->second;
     }
@@ -461,6 +512,12 @@ void Gothic::setMarvinEnabled(bool m) {
   isMarvin = m;
   }
 
+void Gothic::setRandomSeed(uint32_t seed) {
+  randSeed = seed;
+  randGen.seed(seed);
+  std::srand(seed);
+  }
+
 float Gothic::interfaceScale(const Tempest::Widget* w) {
   float mul = 1;
   if(instance->opts.interfaceScale>0.0)
@@ -505,6 +562,8 @@ bool Gothic::finishLoading() {
     saveTex = Texture2d();
     loadTex = Texture2d();
     onWorldLoaded();
+    if(game!=nullptr)
+      prewarmSoundFx();
     return true;
     }
   return false;
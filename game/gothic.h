@@ -97,6 +97,7 @@ class Gothic final {
 
     SoundFx*     loadSoundFx   (std::string_view name);
     SoundFx*     loadSoundWavFx(std::string_view name);
+    void         prewarmSoundFx();
 
     auto         loadParticleFx(std::string_view name, bool relaxed=false) -> const ParticleFx*;
     auto         loadParticleFx(const ParticleFx* base, const VisualFx::Key* key) -> const ParticleFx*;
@@ -123,6 +124,10 @@ class Gothic final {
     bool         isGodMode() const { return godMode; }
     void         setGodMode(bool g) { godMode = g; }
 
+    // seeds hlp_random, script random and std::rand; used for reproducible runs
+    void         setRandomSeed(uint32_t seed);
+    uint32_t     randomSeed() const { return randSeed; }
+
     void         toggleDesktop() { desktop = !desktop; }
     bool         isDesktop() { return desktop; }
 
@@ -207,6 +212,7 @@ class Gothic final {
     VersionInfo                             vinfo;
     Options                                 opts;
     std::mt19937                            randGen;
+    uint32_t                                randSeed = std::mt19937::default_seed;
     uint16_t                                pauseSum=0;
     bool                                    isMarvin       = false;
     bool                                    godMode        = false;
@@ -242,6 +248,8 @@ class Gothic final {
     std::unordered_map<std::string,SoundFx> sndFxCache;
     std::unordered_map<std::string,SoundFx> sndWavCache;
     std::vector<Tempest::SoundEffect>       sndStorage;
+    std::thread                             sndPrewarm;
+    std::atomic_bool                        sndPrewarmStop{false};
 
     std::vector<std::unique_ptr<DocumentMenu::Show>> documents;
     ChapterScreen::Show                     chapter;
@@ -256,6 +264,7 @@ class Gothic final {
                                                               const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
 
     void                                    detectGothicVersion();
+    void                                    stopPrewarmSoundFx();
     void                                    setupSettings();
 
     auto                                    getDocument(int id) -> std::unique_ptr<DocumentMenu::Show>&;
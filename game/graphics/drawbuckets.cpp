@@ -117,9 +117,17 @@ void DrawBuckets::updateBindlessArrays() {
   }
 
 bool DrawBuckets::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
-  if(!bucketsDurtyBit)
-    return false;
+  const uint32_t texGen = Resources::textureGeneration();
+  if(!bucketsDurtyBit) {
+    if(texGeneration==texGen)
+      return false;
+    // async textures were swapped-in: only descriptors are affected
+    texGeneration = texGen;
+    updateBindlessArrays();
+    return true;
+    }
   bucketsDurtyBit = false;
+  texGeneration   = texGen;
 
   std::vector<BucketGpu> bucket;
   for(auto& i:bucketsCpu) {
@@ -87,4 +87,5 @@ class DrawBuckets {
     std::vector<Bucket>      bucketsCpu;
     Tempest::StorageBuffer   bucketsGpu;
     bool                     bucketsDurtyBit = false;
+    uint32_t                 texGeneration   = 0;
   };
@@ -63,21 +63,7 @@ void DrawClusters::free(uint32_t id, uint32_t numCluster) {
     markClusters(id + i);
     }
 
-  Range r = {id, id+numCluster};
-  auto at = std::lower_bound(freeList.begin(),freeList.end(),r,[](const Range& l, const Range& r){
-    return l.begin<r.begin;
-    });
-  at = freeList.insert(at,r);
-  auto next = at+1;
-  if(next!=freeList.end() && at->end==next->begin) {
-    next->begin = at->begin;
-    at = freeList.erase(at);
-    }
-  if(at!=freeList.begin() && at->begin==(at-1)->end) {
-    auto prev = (at-1);
-    prev->end = at->end;
-    at = freeList.erase(at);
-    }
+  freeList.free(id, numCluster);
   }
 
 bool DrawClusters::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
@@ -103,25 +89,9 @@ bool DrawClusters::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
   }
 
 size_t DrawClusters::implAlloc(size_t count) {
-  size_t bestFit = size_t(-1), bfDiff = size_t(-1);
-  for(size_t i=0; i<freeList.size(); ++i) {
-    auto f  = freeList[i];
-    auto sz = (f.end - f.begin);
-    if(sz==count) {
-      freeList.erase(freeList.begin()+int(i));
-      return f.begin;
-      }
-    if(sz<count)
-      continue;
-    if(sz-count < bfDiff)
-      bestFit = i;
-    }
-
-  if(bestFit != size_t(-1)) {
-    auto& f = freeList[bestFit];
-    f.end -= count;
-    return f.end;
-    }
+  const size_t at = freeList.alloc(count);
+  if(at!=RangeAllocator::npos)
+    return at;
 
   size_t ret = clusters.size();
   clusters.resize(clusters.size() + count);
@@ -6,6 +6,7 @@
 
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "graphics/drawbuckets.h"
+#include "utils/rangeallocator.h"
 
 class DrawClusters {
   public:
@@ -38,11 +39,6 @@ class DrawClusters {
     auto     ssbo() const -> const Tempest::StorageBuffer& { return clustersGpu; }
 
   private:
-    struct Range {
-      size_t begin = 0;
-      size_t end   = 0;
-      };
-
     struct ScratchPatch {
       std::vector<uint32_t> header;
       std::vector<Cluster>  patch;
@@ -57,7 +53,7 @@ class DrawClusters {
     size_t                         implAlloc(size_t count);
 
     std::vector<Cluster>           clusters;
-    std::vector<Range>             freeList;
+    RangeAllocator                 freeList;
     Tempest::StorageBuffer         clustersGpu;
     std::vector<uint32_t>          clustersDurty;
     std::atomic_bool               clustersDurtyBit {false};
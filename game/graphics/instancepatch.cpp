@@ -0,0 +1,85 @@
+#include "instancepatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+void InstancePatch::resize(size_t dataSize) {
+  blockCnt = (dataSize+blockSz-1)/blockSz;
+  durty.resize((blockCnt+32-1)/32, 0);
+  }
+
+void InstancePatch::markBlock(size_t id) {
+  static_assert(sizeof(std::atomic<uint32_t>)==sizeof(uint32_t));
+  auto& bits = durty[id/32];
+  id %= 32;
+  reinterpret_cast<std::atomic<uint32_t>&>(bits).fetch_or(1u << id, std::memory_order_relaxed);
+  }
+
+void InstancePatch::markRange(size_t begin, size_t size) {
+  for(size_t i=begin/blockSz; i<(begin+size+blockSz-1)/blockSz; ++i)
+    markBlock(i);
+  }
+
+void InstancePatch::clear() {
+  std::memset(durty.data(), 0, durty.size()*sizeof(durty[0]));
+  }
+
+bool InstancePatch::isDurty(size_t id) const {
+  auto bits = durty[id/32];
+  id %= 32;
+  return bits & (1u << id);
+  }
+
+size_t InstancePatch::build(std::vector<Path>& patches, bool& deferred) {
+  patches.clear();
+  deferred = false;
+
+  size_t payloadSize = 0;
+  size_t i           = 0;
+  for(; i<blockCnt; ++i) {
+    if(i%32==0 && durty[i/32]==0) {
+      i+=31;
+      continue;
+      }
+    if(!isDurty(i))
+      continue;
+
+    // coalesce runs, separated by short clean gaps
+    auto begin = i, end = i+1;
+    for(i=end; i<blockCnt && i<=end+mergeGap; ++i) {
+      if(isDurty(i))
+        end = i+1;
+      }
+    i = end;
+
+    uint32_t size = uint32_t((end-begin)*blockSz);
+    if(payloadSize>0 && payloadSize+size>uploadBudget) {
+      // over budget: keep the rest dirty, for next frame
+      i = begin;
+      deferred = true;
+      break;
+      }
+
+    Path p = {};
+    p.dst  = uint32_t(begin*blockSz);
+    p.src  = uint32_t(payloadSize);
+    while(size>0) {
+      p.size       = std::min(size, uint32_t(chunkSz));
+      size        -= p.size;
+      patches.push_back(p);
+
+      payloadSize += p.size;
+      p.dst       += p.size;
+      p.src       += p.size;
+      }
+    }
+
+  if(i>=blockCnt) {
+    clear();
+    } else {
+    std::memset(durty.data(), 0, (i/32)*sizeof(durty[0]));
+    durty[i/32] &= ~((1u << (i%32)) - 1u);
+    }
+  return payloadSize;
+  }
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// CPU side of InstanceStorage delta upload: dirty bits per block and list of patches to apply on gpu.
+// Does not touch the device, so can be used and tested without one.
+class InstancePatch final {
+  public:
+    static constexpr size_t blockSz      = 64;
+    static constexpr size_t uploadBudget = 2*1024*1024; // bytes per frame; rest is deferred
+    static constexpr size_t mergeGap     = 1;           // clean blocks, merged into neighbour patches
+    static constexpr size_t chunkSz      = 256;         // max size of one patch, one workgroup in shader
+
+    struct Path {
+      uint32_t dst;
+      uint32_t src;
+      uint32_t size;
+      };
+
+    void   resize(size_t dataSize);
+    void   markBlock(size_t id);
+    void   markRange(size_t begin, size_t size);
+    void   clear();
+
+    bool   isDurty(size_t id) const;
+    size_t blockCount() const { return blockCnt; }
+
+    // fills patches with dst/src in bytes, src relative to payload; returns payload size
+    size_t build(std::vector<Path>& patches, bool& deferred);
+
+  private:
+    std::vector<uint32_t> durty;
+    size_t                blockCnt = 0;
+  };
@@ -23,17 +23,13 @@ static uint32_t alignAs(uint32_t sz, uint32_t alignment) {
   return ((sz+alignment-1)/alignment)*alignment;
   }
 
-static void bitSet(std::vector<uint32_t>& b, size_t id) {
-  static_assert(sizeof(std::atomic<uint32_t>)==sizeof(uint32_t));
-  auto& bits = b[id/32];
-  id %= 32;
-  reinterpret_cast<std::atomic<uint32_t>&>(bits).fetch_or(1u << id, std::memory_order_relaxed);
-  }
-
-static bool bitAt(std::vector<uint32_t>& b, size_t id) {
-  auto bits = b[id/32];
-  id %= 32;
-  return bits & (1u << id);
+static bool isChanged(const Matrix4x4& a, const Matrix4x4& b, float eps) {
+  auto pa = a.data();
+  auto pb = b.data();
+  for(size_t i=0; i<16; ++i)
+    if(std::abs(pa[i]-pb[i])>eps)
+      return true;
+  return false;
   }
 
 using namespace Tempest;
@@ -58,11 +54,17 @@ void InstanceStorage::Id::set(const Tempest::Matrix4x4* mat) {
   if(owner==nullptr)
     return;
 
-  auto data = reinterpret_cast<Matrix4x4*>(owner->dataCpu.data() + rgn.begin);
-  std::memcpy(data, mat, rgn.asize);
+  static_assert(sizeof(Matrix4x4)==blockSz);
 
-  for(size_t i=0; i<rgn.asize; i+=blockSz)
-    bitSet(owner->durty, (rgn.begin+i)/blockSz);
+  // upload only bones, that actually moved
+  auto         data = reinterpret_cast<Matrix4x4*>(owner->dataCpu.data() + rgn.begin);
+  const size_t cnt  = rgn.asize/sizeof(Matrix4x4);
+  for(size_t i=0; i<cnt; ++i) {
+    if(!isChanged(data[i], mat[i], boneEpsilon))
+      continue;
+    data[i] = mat[i];
+    owner->durty.markBlock(rgn.begin/blockSz + i);
+    }
   }
 
 void InstanceStorage::Id::set(const Tempest::Matrix4x4& obj, size_t offset) {
@@ -73,7 +75,7 @@ void InstanceStorage::Id::set(const Tempest::Matrix4x4& obj, size_t offset) {
   if(data[offset] == obj)
     return;
   data[offset] = obj;
-  bitSet(owner->durty, (rgn.begin+offset*sizeof(Matrix4x4))/blockSz);
+  owner->durty.markBlock((rgn.begin+offset*sizeof(Matrix4x4))/blockSz);
   }
 
 void InstanceStorage::Id::set(const void* data, size_t offset, size_t size) {
@@ -90,12 +92,12 @@ void InstanceStorage::Id::set(const void* data, size_t offset, size_t size) {
     for(size_t i=0; i<size; i+=blockSz) {
       const size_t sz = std::min(blockSz, size-i);
       std::memcpy(dst+i, src+i, sz);
-      bitSet(owner->durty, (rgn.begin + offset + i)/blockSz);
+      owner->durty.markBlock((rgn.begin + offset + i)/blockSz);
       }
     } else {
     for(size_t i=0; i<size; ++i) {
       dst[i] = src[i];
-      bitSet(owner->durty, (rgn.begin + offset + i)/blockSz);
+      owner->durty.markBlock((rgn.begin + offset + i)/blockSz);
       }
     }
   }
@@ -113,6 +115,7 @@ InstanceStorage::InstanceStorage() {
   }
 
 InstanceStorage::~InstanceStorage() {
+  join();
   {
     std::unique_lock<std::mutex> lck(sync);
     uploadFId = Resources::MaxFramesInFlight;
@@ -132,44 +135,17 @@ bool InstanceStorage::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
     Resources::recycle(std::move(dataGpu));
     dataGpu = device.ssbo(BufferHeap::Device,Tempest::Uninitialized,dataSize);
     dataGpu.update(dataCpu);
-    std::memset(durty.data(), 0, durty.size()*sizeof(uint32_t));
-    return true;
-    }
+    durty.clear();
 
-  patchBlock.clear();
-  size_t payloadSize = 0;
-  for(size_t i = 0; i<blockCnt; ++i) {
-    if(i%32==0 && durty[i/32]==0) {
-      i+=31;
-      continue;
-      }
-    if(!bitAt(durty,i))
-      continue;
-    auto begin = i; ++i;
-    while(i<blockCnt) {
-      if(!bitAt(durty,i))
-        break;
-      ++i;
-      }
-
-    uint32_t size    = uint32_t((i-begin)*blockSz);
-    uint32_t chunkSz = 256;
-
-    Path p = {};
-    p.dst  = uint32_t(begin*blockSz);
-    p.src  = uint32_t(payloadSize);
-    while(size>0) {
-      p.size       = std::min<uint32_t>(size, chunkSz);
-      size        -= p.size;
-      patchBlock.push_back(p);
-
-      payloadSize += p.size;
-      p.dst       += p.size;
-      p.src       += p.size;
-      }
+    stat.uploadBytes = dataCpu.size();
+    stat.patches     = 0;
+    stat.deferred    = false;
+    return true;
     }
-  std::memset(durty.data(), 0, durty.size()*sizeof(durty[0]));
 
+  const size_t payloadSize = durty.build(patchBlock, stat.deferred);
+  stat.uploadBytes = 0;
+  stat.patches     = patchBlock.size();
   if(patchBlock.size()==0)
     return false;
 
@@ -185,6 +161,7 @@ bool InstanceStorage::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
     i.size /= 4;
     }
   std::memcpy(patchCpu.data(), patchBlock.data(), headerSize);
+  stat.uploadBytes = patchCpu.size();
 
   auto& path = patchGpu[fId];
   if(path.byteSize() < headerSize + payloadSize) {
@@ -207,11 +184,8 @@ bool InstanceStorage::commit(Encoder<CommandBuffer>& cmd, uint8_t fId) {
   }
 
 void InstanceStorage::join() {
-  while(true) {
-    std::unique_lock<std::mutex> lck(sync);
-    if(uploadFId<0)
-      break;
-    }
+  std::unique_lock<std::mutex> lck(sync);
+  uploadDone.wait(lck, [this](){ return uploadFId<0; });
   }
 
 InstanceStorage::Id InstanceStorage::alloc(const size_t size) {
@@ -219,26 +193,13 @@ InstanceStorage::Id InstanceStorage::alloc(const size_t size) {
     return Id(*this,Range());
 
   const auto nsize = alignAs(nextPot(uint32_t(size)), alignment);
-  for(size_t i=0; i<rgn.size(); ++i) {
-    if(rgn[i].size==nsize) {
-      auto ret = rgn[i];
-      ret.asize = size;
-      rgn.erase(rgn.begin()+intptr_t(i));
-      return Id(*this,ret);
-      }
-    }
-  size_t retId = size_t(-1);
-  for(size_t i=0; i<rgn.size(); ++i) {
-    if(rgn[i].size>nsize && (retId==size_t(-1) || rgn[i].size<rgn[retId].size)) {
-      retId = i;
-      }
-    }
-  if(retId!=size_t(-1)) {
-    Range ret = rgn[retId];
+  const auto at    = freeMem.alloc(nsize);
+  if(at!=RangeAllocator::npos) {
+    Range ret;
+    ret.begin = at;
     ret.size  = nsize;
     ret.asize = size;
-    rgn[retId].begin += nsize;
-    rgn[retId].size  -= nsize;
+    markDurty(ret);
     return Id(*this,ret);
     }
   Range r;
@@ -247,12 +208,17 @@ InstanceStorage::Id InstanceStorage::alloc(const size_t size) {
   r.asize = size;
 
   dataCpu.resize(dataCpu.size() + nsize);
-
-  blockCnt = (dataCpu.size()+blockSz-1)/blockSz;
-  durty.resize((blockCnt+32-1)/32, 0);
+  durty.resize(dataCpu.size());
+  markDurty(r);
   return Id(*this,r);
   }
 
+void InstanceStorage::markDurty(const Range& r) {
+  // gpu content of fresh range is unknown (uninitialized tail of ssbo, or stale data),
+  // so comparison against cpu copy in Id::set can't be trusted until first upload
+  durty.markRange(r.begin, r.size);
+  }
+
 bool InstanceStorage::realloc(Id& id, const size_t size) {
   if(size==0) {
     if(id.isEmpty())
@@ -272,11 +238,9 @@ bool InstanceStorage::realloc(Id& id, const size_t size) {
     return true;
     }
 
+  // new range is marked dirty by alloc
   auto data = dataCpu.data();
   std::memcpy(data+next.rgn.begin, data+id.rgn.begin, id.rgn.asize);
-  for(size_t i=0; i<id.rgn.asize; ++i) {
-    bitSet(durty, (next.rgn.begin + i)/blockSz);
-    }
   id = std::move(next);
   return true;
   }
@@ -286,34 +250,25 @@ const Tempest::StorageBuffer& InstanceStorage::ssbo() const {
   }
 
 void InstanceStorage::free(const Range& r) {
-  for(auto& i:rgn) {
-    if(i.begin+i.size==r.begin) {
-      i.size  += r.size;
-      return;
-      }
-    if(r.begin+r.size==i.begin) {
-      i.begin -= r.size;
-      i.size  += r.size;
-      return;
-      }
-    }
-  auto at = std::lower_bound(rgn.begin(),rgn.end(),r,[](const Range& l, const Range& r){
-    return l.begin<r.begin;
-    });
-  rgn.insert(at,r);
+  freeMem.free(r.begin, r.size);
   }
 
 void InstanceStorage::uploadMain() {
   Workers::setThreadName("InstanceStorage upload");
   while(true) {
     std::unique_lock<std::mutex> lck(sync);
-    uploadCnd.wait(lck);
+    uploadCnd.wait(lck, [this](){ return uploadFId>=0; });
     if(uploadFId==Resources::MaxFramesInFlight)
       break;
-    if(uploadFId<0)
-      continue;
 
-    patchGpu[uploadFId].update(patchCpu);
+    // patchCpu is not touched by main thread, until join
+    const auto fId = uploadFId;
+    lck.unlock();
+    patchGpu[fId].update(patchCpu);
+
+    lck.lock();
     uploadFId = -1;
+    lck.unlock();
+    uploadDone.notify_all();
     }
   }
@@ -9,6 +9,8 @@
 #include <thread>
 
 #include "resources.h"
+#include "utils/rangeallocator.h"
+#include "instancepatch.h"
 
 class InstanceStorage {
   private:
@@ -18,9 +20,11 @@ class InstanceStorage {
       size_t asize = 0;
       };
 
-    static constexpr size_t blockSz   = 64;
+    static constexpr size_t blockSz   = InstancePatch::blockSz;
     static constexpr size_t alignment = 64;
 
+    static constexpr float  boneEpsilon  = 1e-4f;
+
   public:
     class Id {
       public:
@@ -46,6 +50,12 @@ class InstanceStorage {
       friend class InstanceStorage;
       };
 
+    struct Stats {
+      size_t uploadBytes = 0;
+      size_t patches     = 0;
+      bool   deferred    = false;
+      };
+
     InstanceStorage();
     ~InstanceStorage();
 
@@ -54,20 +64,17 @@ class InstanceStorage {
     auto ssbo () const -> const Tempest::StorageBuffer&;
     bool commit(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId);
     void join();
+    auto stats() const -> const Stats& { return stat; }
 
   private:
     void free(const Range& r);
+    void markDurty(const Range& r);
     void uploadMain();
 
-    struct Path {
-      uint32_t dst;
-      uint32_t src;
-      uint32_t size;
-      };
+    using Path = InstancePatch::Path;
 
-    std::vector<Range>      rgn;
-    std::vector<uint32_t>   durty;
-    size_t                  blockCnt = 0;
+    RangeAllocator          freeMem;
+    InstancePatch           durty;
 
     Tempest::StorageBuffer  patchGpu[Resources::MaxFramesInFlight];
     std::vector<uint8_t>    patchCpu;
@@ -78,6 +85,8 @@ class InstanceStorage {
 
     std::thread             uploadTh;
     std::mutex              sync;
-    std::condition_variable uploadCnd;
+    std::condition_variable uploadCnd, uploadDone;
     int32_t                 uploadFId = -1;
+
+    Stats                   stat;
   };
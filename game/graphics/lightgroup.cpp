@@ -10,6 +10,7 @@
 #include "utils/string_frm.h"
 #include "world/world.h"
 #include "utils/dbgpainter.h"
+#include "utils/workers.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -69,6 +70,7 @@ void LightGroup::Light::setRange(float r) {
   auto& ssbo = owner->lightSourceData[id];
   ssbo.range = data.isEnabled() ? clampRange(r) : 0;
   owner->markAsDurty(id);
+  owner->updateAnimGroup(id);
   }
 
 void LightGroup::Light::setColor(const Vec3& c) {
@@ -80,6 +82,7 @@ void LightGroup::Light::setColor(const Vec3& c) {
   auto& ssbo = owner->lightSourceData[id];
   ssbo.color = c;
   owner->markAsDurty(id);
+  owner->updateAnimGroup(id);
   }
 
 void LightGroup::Light::setColor(const std::vector<Vec3>& c, float fps, bool smooth) {
@@ -91,6 +94,7 @@ void LightGroup::Light::setColor(const std::vector<Vec3>& c, float fps, bool smo
   auto& ssbo = owner->lightSourceData[id];
   ssbo.color = data.currentColor();
   owner->markAsDurty(id);
+  owner->updateAnimGroup(id);
   }
 
 void LightGroup::Light::setTimeOffset(uint64_t t) {
@@ -98,6 +102,7 @@ void LightGroup::Light::setTimeOffset(uint64_t t) {
     return;
   auto& data = owner->lightSourceDesc[id];
   data.setTimeOffset(t);
+  owner->updateAnimGroup(id);
   }
 
 uint64_t LightGroup::Light::effectPrefferedTime() const {
@@ -150,7 +155,7 @@ LightGroup::Light LightGroup::add(const zenkit::LightPreset& vob) {
     }
 
   std::lock_guard<std::mutex> guard(sync);
-  size_t id = alloc(l.isDynamic());
+  size_t id = alloc();
   auto   lx = Light(*this, id);
 
   auto& ssbo = lightSourceData[lx.id];
@@ -162,6 +167,7 @@ LightGroup::Light LightGroup::add(const zenkit::LightPreset& vob) {
   data = std::move(l);
 
   markAsDurtyNoSync(lx.id);
+  updateAnimGroupNoSync(lx.id);
   return lx;
   }
 
@@ -246,22 +252,19 @@ void LightGroup::dbgLights(DbgPainter& p) const {
   p.drawText(10,50,name);
   }
 
-size_t LightGroup::alloc(bool dynamic) {
+size_t LightGroup::alloc() {
   if(freeList.size()>0) {
     auto ret = freeList.back();
     freeList.pop_back();
-    if(dynamic)
-      animatedLights.insert(ret);
     markAsDurtyNoSync(ret);
     return ret;
     }
   lightSourceData.emplace_back();
   lightSourceDesc.emplace_back();
+  animRef.emplace_back();
   duryBit.resize((lightSourceData.size()+32u-1u)/32u);
 
   auto ret = lightSourceData.size()-1;
-  if(dynamic)
-    animatedLights.insert(ret);
   markAsDurtyNoSync(ret);
   return ret;
   }
@@ -269,10 +272,11 @@ size_t LightGroup::alloc(bool dynamic) {
 void LightGroup::free(size_t id) {
   std::lock_guard<std::mutex> guard(sync);
   markAsDurtyNoSync(id);
-  animatedLights.erase(id);
+  removeFromAnimGroup(id);
   if(id+1==lightSourceData.size()) {
     lightSourceData.pop_back();
     lightSourceDesc.pop_back();
+    animRef.pop_back();
     duryBit.resize((lightSourceData.size()+32u-1u)/32u);
     } else {
     lightSourceDesc[id].setRange(0);
@@ -294,6 +298,124 @@ void LightGroup::resetDurty() {
   std::memset(duryBit.data(), 0, duryBit.size()*sizeof(duryBit[0]));
   }
 
+void LightGroup::updateAnimGroup(size_t id) {
+  std::lock_guard<std::mutex> guard(sync);
+  updateAnimGroupNoSync(id);
+  }
+
+void LightGroup::updateAnimGroupNoSync(size_t id) {
+  auto& data = lightSourceDesc[id];
+  if(animRef[id].group!=uint32_t(-1)) {
+    auto& g = animGroups[animRef[id].group];
+    if(data.isDynamic() && g.anim.isSameAnimation(data))
+      return;
+    removeFromAnimGroup(id);
+    }
+
+  if(!data.isDynamic())
+    return;
+
+  const uint64_t hash  = data.animationHash();
+  uint32_t       group = uint32_t(-1);
+  auto           range = animGroupsIndex.equal_range(hash);
+  for(auto i=range.first; i!=range.second; ++i) {
+    if(animGroups[i->second].anim.isSameAnimation(data)) {
+      group = i->second;
+      break;
+      }
+    }
+
+  if(group==uint32_t(-1)) {
+    if(!animGroupsFree.empty()) {
+      group = animGroupsFree.back();
+      animGroupsFree.pop_back();
+      } else {
+      group = uint32_t(animGroups.size());
+      animGroups.emplace_back();
+      }
+    animGroups[group].anim = data;
+    animGroups[group].hash = hash;
+    animGroupsIndex.emplace(hash, group);
+    }
+
+  auto& g = animGroups[group];
+  animRef[id].group = group;
+  animRef[id].slot  = uint32_t(g.lights.size());
+  g.lights.push_back(uint32_t(id));
+  animChanged = true;
+  }
+
+void LightGroup::removeFromAnimGroup(size_t id) {
+  auto& ref = animRef[id];
+  if(ref.group==uint32_t(-1))
+    return;
+
+  auto& g    = animGroups[ref.group];
+  auto  last = g.lights.back();
+  g.lights[ref.slot]  = last;
+  animRef[last].slot  = ref.slot;
+  g.lights.pop_back();
+
+  if(g.lights.empty()) {
+    auto range = animGroupsIndex.equal_range(g.hash);
+    for(auto i=range.first; i!=range.second; ++i) {
+      if(i->second==ref.group) {
+        animGroupsIndex.erase(i);
+        break;
+        }
+      }
+    g.anim = LightSource();
+    animGroupsFree.push_back(ref.group);
+    }
+
+  ref         = AnimRef();
+  animChanged = true;
+  }
+
+void LightGroup::mkAnimTasks() {
+  animatedIds.clear();
+  for(auto& g:animGroups)
+    animatedIds.insert(animatedIds.end(), g.lights.begin(), g.lights.end());
+  std::sort(animatedIds.begin(), animatedIds.end());
+
+  // split by 32-light words, so tasks never share a dirty-bit mask
+  const size_t count   = animatedIds.size();
+  const size_t thCount = std::min<size_t>(Workers::maxThreads(), (count+minLightsPerTask-1)/minLightsPerTask);
+  animTasks.clear();
+  animTasks.push_back(0);
+  for(size_t i=1; i<thCount; ++i) {
+    size_t b = (count*i)/thCount;
+    while(b<count && animatedIds[b]/32==animatedIds[b-1]/32)
+      ++b;
+    if(b<count && b>animTasks.back())
+      animTasks.push_back(b);
+    }
+  animTasks.push_back(count);
+  animChanged = false;
+  }
+
+size_t LightGroup::tickAnimated(size_t begin, size_t end) {
+  size_t updates = 0;
+  for(size_t i=begin; i<end; ++i) {
+    const uint32_t id    = animatedIds[i];
+    auto&          light = lightSourceDesc[id];
+    auto&          anim  = animGroups[animRef[id].group].anim;
+
+    LightSsbo ssbo;
+    ssbo.pos   = light.position();
+    ssbo.color = anim.currentColor();
+    ssbo.range = light.isEnabled() ? clampRange(anim.currentRange()) : 0;
+
+    auto& dst = lightSourceData[id];
+    if(std::memcmp(&dst, &ssbo, sizeof(ssbo))==0)
+      continue;
+    dst = ssbo;
+    markAsDurtyNoSync(id);
+    ++updates;
+    }
+  return updates;
+  }
+
 const zenkit::LightPreset& LightGroup::findPreset(std::string_view preset) const {
   for(auto& i:presets) {
     if(i.preset!=preset)
@@ -306,21 +428,27 @@ const zenkit::LightPreset& LightGroup::findPreset(std::string_view preset) const
   }
 
 void LightGroup::tick(uint64_t time) {
-  for(size_t i : animatedLights) {
-    auto& light = lightSourceDesc[i];
-    light.update(time);
+  std::lock_guard<std::mutex> guard(sync);
+  if(animChanged)
+    mkAnimTasks();
 
-    LightSsbo ssbo;
-    ssbo.pos   = light.position();
-    ssbo.color = light.currentColor();
-    ssbo.range = light.isEnabled() ? clampRange(light.currentRange()) : 0;
+  for(auto& g:animGroups) {
+    if(!g.lights.empty())
+      g.anim.update(time);
+    }
 
-    auto& dst = lightSourceData[i];
-    if(std::memcmp(&dst, &ssbo, sizeof(ssbo))==0)
-      continue;
-    dst = ssbo;
-    markAsDurtyNoSync(i);
+  std::atomic_size_t updates{0};
+  if(animTasks.size()<=2) {
+    updates = tickAnimated(0, animatedIds.size());
+    } else {
+    Workers::parallelTasks(animTasks.size()-1, [this,&updates](size_t i) {
+      updates += tickAnimated(animTasks[i], animTasks[i+1]);
+      });
     }
+
+  stat.animated = animatedIds.size();
+  stat.groups   = animGroupsIndex.size();
+  stat.updates  = updates;
   }
 
 bool LightGroup::updateLights() {
@@ -336,8 +464,9 @@ bool LightGroup::updateLights() {
   }
 
 void LightGroup::prepareGlobals(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId) {
-  std::vector<Path>      patchBlock;
-  std::vector<LightSsbo> patchData;
+  patchBlock.clear();
+  patchData.clear();
+  stat.patchBytes = 0;
 
   for(size_t i=0; i<lightSourceDesc.size(); ++i) {
     if(i%32==0 && duryBit[i/32]==0) {
@@ -370,6 +499,7 @@ void LightGroup::prepareGlobals(Tempest::Encoder<Tempest::CommandBuffer>& cmd, u
 
   const size_t headerSize = patchBlock.size()*sizeof(Path);
   const size_t dataSize   = patchData .size()*sizeof(LightSsbo);
+  stat.patchBytes = headerSize+dataSize;
   for(auto& i:patchBlock) {
     i.dst  *= uint32_t(sizeof(LightSsbo));
     i.src  *= uint32_t(sizeof(LightSsbo));
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Tempest/CommandBuffer>
+#include <unordered_map>
 #include <unordered_set>
+#include <mutex>
 #include <zenkit/vobs/Light.hh>
 
 #include "lightsource.h"
@@ -15,6 +17,13 @@ class LightGroup final {
   public:
     LightGroup(const SceneGlobals& scene);
 
+    struct Stats {
+      size_t animated   = 0;
+      size_t groups     = 0;
+      size_t updates    = 0;
+      size_t patchBytes = 0;
+      };
+
     class Light final {
       public:
         Light() = default;
@@ -52,6 +61,7 @@ class LightGroup final {
     auto&  lightsSsbo() const { return lightSourceSsbo; }
 
     void   prepareGlobals(Tempest::Encoder<Tempest::CommandBuffer> &cmd, uint8_t fId);
+    auto   stats() const -> const Stats& { return stat; }
 
     void   dbgLights(DbgPainter& p) const;
 
@@ -75,13 +85,33 @@ class LightGroup final {
       uint32_t mask[6];
       };
 
-    size_t                     alloc(bool dynamic);
+    // lights with identical animation (preset, fps, time offset) are evaluated once per frame
+    struct AnimGroup {
+      LightSource           anim;
+      uint64_t              hash = 0;
+      std::vector<uint32_t> lights;
+      };
+
+    struct AnimRef {
+      uint32_t group = uint32_t(-1);
+      uint32_t slot  = 0;
+      };
+
+    static constexpr size_t    minLightsPerTask = 256;
+
+    size_t                     alloc();
     void                       free(size_t id);
 
     void                       markAsDurty(size_t id);
     void                       markAsDurtyNoSync(size_t id);
     void                       resetDurty();
 
+    void                       updateAnimGroup(size_t id);
+    void                       updateAnimGroupNoSync(size_t id);
+    void                       removeFromAnimGroup(size_t id);
+    void                       mkAnimTasks();
+    size_t                     tickAnimated(size_t begin, size_t end);
+
     const zenkit::LightPreset& findPreset(std::string_view preset) const;
 
     std::vector<zenkit::LightPreset> presets;
@@ -90,9 +120,20 @@ class LightGroup final {
     std::vector<size_t>              freeList;
     std::vector<LightSource>         lightSourceDesc;
     std::vector<LightSsbo>           lightSourceData;
-    std::unordered_set<size_t>       animatedLights;
     std::vector<uint32_t>            duryBit;
 
+    std::vector<AnimGroup>           animGroups;
+    std::vector<uint32_t>            animGroupsFree;
+    std::unordered_multimap<uint64_t,uint32_t> animGroupsIndex;
+    std::vector<AnimRef>             animRef;
+    std::vector<uint32_t>            animatedIds;
+    std::vector<size_t>              animTasks;
+    bool                             animChanged = false;
+
+    std::vector<Path>                patchBlock;
+    std::vector<LightSsbo>           patchData;
+    Stats                            stat;
+
     Tempest::StorageBuffer           lightSourceSsbo;
     Tempest::StorageBuffer           patchSsbo[Resources::MaxFramesInFlight];
   };
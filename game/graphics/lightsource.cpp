@@ -148,6 +148,38 @@ void LightSource::setTimeOffset(uint64_t t) {
   timeOff = t;
   }
 
+uint64_t LightSource::animationHash() const {
+  uint64_t h = 0xcbf29ce484222325;
+  auto mix = [&h](const void* data, size_t size) {
+    auto b = reinterpret_cast<const uint8_t*>(data);
+    for(size_t i=0; i<size; ++i) {
+      h ^= b[i];
+      h *= 0x100000001b3;
+      }
+    };
+  mix(&timeOff,            sizeof(timeOff));
+  mix(&rangeAniFPSInv,     sizeof(rangeAniFPSInv));
+  mix(&colorAniListFpsInv, sizeof(colorAniListFpsInv));
+  mix(&rgn,                sizeof(rgn));
+  mix(&clr,                sizeof(clr));
+  mix(rangeAniScale.data(), rangeAniScale.size()*sizeof(rangeAniScale[0]));
+  mix(colorAniList.data(),  colorAniList.size()*sizeof(colorAniList[0]));
+  h ^= (rangeSmooth ? 1 : 0) | (colorSmooth ? 2 : 0);
+  return h;
+  }
+
+bool LightSource::isSameAnimation(const LightSource& other) const {
+  return timeOff           ==other.timeOff            &&
+         rgn               ==other.rgn                &&
+         clr               ==other.clr                &&
+         rangeAniFPSInv    ==other.rangeAniFPSInv     &&
+         rangeSmooth       ==other.rangeSmooth        &&
+         rangeAniScale     ==other.rangeAniScale      &&
+         colorAniListFpsInv==other.colorAniListFpsInv &&
+         colorSmooth       ==other.colorSmooth        &&
+         colorAniList      ==other.colorAniList;
+  }
+
 uint64_t LightSource::effectPrefferedTime() const {
   uint64_t t0 = colorAniList .size()*colorAniListFpsInv;
   uint64_t t1 = rangeAniScale.size()*rangeAniFPSInv;
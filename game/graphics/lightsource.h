@@ -36,6 +36,9 @@ class LightSource final {
 
     void                 setTimeOffset(uint64_t t);
 
+    uint64_t             animationHash() const;
+    bool                 isSameAnimation(const LightSource& other) const;
+
     uint64_t             effectPrefferedTime() const;
 
     void                 setDebugName(std::string_view hint);
@@ -11,7 +11,7 @@ static Tempest::Color toColor(zenkit::Color v) {
   }
 
 Material::Material(const zenkit::Material& m, bool enableAlphaTest) {
-  tex = Resources::loadTexture(m.texture);
+  tex = Resources::loadTextureAsync(m.texture);
   if(tex==nullptr) {
     if(!m.texture.empty()) {
       tex = Resources::loadTexture("DEFAULT.TGA");
@@ -140,7 +140,7 @@ Material::AlphaFunc Material::loadAlphaFunc(zenkit::AlphaFunction zenAlpha,
     }
 
   if(alpha==Material::AlphaFunc::AlphaTest || alpha==Material::AlphaFunc::Transparent) {
-    if(tex!=nullptr && tex->format()==Tempest::TextureFormat::DXT1 && clrAlpha==255) {
+    if(tex!=nullptr && Resources::textureFormat(*tex)==Tempest::TextureFormat::DXT1 && clrAlpha==255) {
       alpha = Material::AlphaFunc::Solid;
       }
     }
@@ -497,8 +497,9 @@ bool MdlVisual::isUsingTorch() const {
   }
 
 bool MdlVisual::updateAnimation(Npc* npc, Interactive* mobsi, World& world, uint64_t dt) {
+  // sampled at display rate: simulation clock advances only once per fixed step
   Pose&    pose      = *skInst;
-  uint64_t tickCount = world.tickCount();
+  uint64_t tickCount = world.renderTickCount();
   auto     pos3      = Vec3{pos.at(3,0), pos.at(3,1), pos.at(3,2)};
 
   if(npc!=nullptr && world.isInSfxRange(pos3))
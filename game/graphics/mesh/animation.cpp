@@ -103,6 +103,19 @@ void Animation::debug() const {
     Log::d(i.name);
   }
 
+void Animation::soundEffects(std::vector<std::string>& out) const {
+  for(auto& sq:sequences) {
+    if(sq.data==nullptr)
+      continue;
+    for(auto& i:sq.data->sfx)
+      out.push_back(i.name);
+    // ground sounds are resolved per material, see Npc::emitSoundGround
+    for(auto& i:sq.data->gfx)
+      for(auto mat:MaterialGroupNames)
+        out.emplace_back(std::string_view(string_frm(i.name,"_",mat)));
+    }
+  }
+
 std::string_view Animation::defaultMesh() const {
   if(!meshDef.name.empty() && !meshDef.disable_mesh)
     return meshDef.name;
@@ -125,6 +125,7 @@ class Animation final {
     const Sequence*    sequenceAsc(std::string_view name) const;
     void               debug() const;
     std::string_view   defaultMesh() const;
+    void               soundEffects(std::vector<std::string>& out) const;
 
   private:
     Sequence&          loadMAN(const zenkit::MdsAnimation& hdr, std::string_view name);
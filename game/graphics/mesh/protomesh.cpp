@@ -67,8 +67,10 @@ ProtoMesh::ProtoMesh(PackedMesh&& pm, const std::vector<zenkit::MorphAnimation>&
   for(size_t i=0; i<aniList.size(); ++i) {
     remap(aniList[i],pm.verticesId,remapId,samples,samplesCnt);
 
-    morphIndex  .update(remapId.data(), i*indexSz,               remapId.size()*sizeof(remapId[0]));
-    morphSamples.update(samples.data(), samplesCnt*sizeof(Vec4), samples.size()*sizeof(Vec4)      );
+    if(!Resources::isHeadless()) {
+      morphIndex  .update(remapId.data(), i*indexSz,               remapId.size()*sizeof(remapId[0]));
+      morphSamples.update(samples.data(), samplesCnt*sizeof(Vec4), samples.size()*sizeof(Vec4)      );
+      }
 
     morph[i] = mkAnimation(aniList[i]);
     morph[i].index = (i*indexSz)/sizeof(int32_t);
@@ -1,12 +1,14 @@
 #include "pfxbucket.h"
 
 #include <cassert>
+#include <limits>
 
 #include "graphics/mesh/submesh/pfxemittermesh.h"
 #include "graphics/shaders.h"
 #include "pfxobjects.h"
 #include "particlefx.h"
 #include "world/objects/npc.h"
+#include "gothic.h"
 
 using namespace Tempest;
 
@@ -25,11 +27,25 @@ static uint64_t ppsDiff(const ParticleFx& decl, bool loop, uint64_t time0, uint6
   return emitted1-emitted0;
   }
 
-float PfxBucket::ParState::lifeTime() const {
-  return 1.f-life/float(maxLife);
+void PfxBucket::Particles::resize(size_t sz, size_t trlCapacity) {
+  life   .resize(sz, 0);
+  maxLife.resize(sz, 1);
+  posX   .resize(sz, 0);
+  posY   .resize(sz, 0);
+  posZ   .resize(sz, 0);
+  dirX   .resize(sz, 0);
+  dirY   .resize(sz, 0);
+  dirZ   .resize(sz, 0);
+  if(trlCapacity>0) {
+    trail  .resize(sz*trlCapacity);
+    trlHead.resize(sz, 0);
+    trlSize.resize(sz, 0);
+    }
   }
 
-std::mt19937 PfxBucket::rndEngine;
+float PfxBucket::Particles::lifeTime(size_t i) const {
+  return 1.f-life[i]/float(maxLife[i]);
+  }
 
 bool PfxBucket::Draw::isEmpty() const {
   return (pfxGpu.byteSize()==0);
@@ -37,6 +53,15 @@ bool PfxBucket::Draw::isEmpty() const {
 
 PfxBucket::PfxBucket(const ParticleFx &decl, PfxObjects& parent, const SceneGlobals& scene, VisualObjects& visual)
   :decl(decl), parent(parent), visual(visual)  {
+  {
+  // FNV-1a of effect name and creation order: reproducible, and decorrelated between buckets
+  uint32_t seed = 0x811c9dc5 ^ Gothic::inst().randomSeed();
+  for(auto c:decl.dbgName)
+    seed = (seed ^ uint8_t(c))*0x01000193;
+  seed ^= parent.bucketSeq++ * 0x9e3779b9;
+  rndEngine.seed(seed);
+  }
+
   uint64_t lt      = decl.maxLifetime();
   uint64_t pps     = uint64_t(std::ceil(decl.maxPps()));
   uint64_t reserve = (lt*pps+1000-1)/1000;
@@ -44,6 +69,17 @@ PfxBucket::PfxBucket(const ParticleFx &decl, PfxObjects& parent, const SceneGlob
   if(blockSize==0)
     blockSize=1;
 
+  {
+  // rough bounding radius of a single emitter, for LOD
+  const float life = float(lt);
+  const float vel  = decl.velAvg + std::abs(decl.velVar);
+  const float size = std::max(decl.visSizeStart.x, decl.visSizeStart.y)*std::max(1.f, decl.visSizeEndScale);
+  lodRadius = (decl.shpDim*0.5f).length() + decl.shpOffsetVec.length() + size +
+              vel*life + 0.5f*decl.flyGravity.length()*life*life;
+  if(decl.shpType==ParticleFx::EmitterType::Mesh)
+    lodRadius += 200.f;
+  }
+
   for(size_t i=0; i<Resources::MaxFramesInFlight; ++i) {
     auto& item = this->item[i];
     if(decl.visMaterial.tex==nullptr)
@@ -54,7 +90,10 @@ PfxBucket::PfxBucket(const ParticleFx &decl, PfxObjects& parent, const SceneGlob
     }
 
   if(decl.hasTrails()) {
-    maxTrlTime = uint64_t(decl.trlFadeSpeed*1000.f);
+    maxTrlTime  = uint64_t(decl.trlFadeSpeed*1000.f);
+    // trail can't be older than fade time or particle itself; one point per trlSampleTime - no truncation
+    const uint64_t trlTime = std::min(maxTrlTime, decl.maxLifetime());
+    trlCapacity = std::min<size_t>(size_t(trlTime/trlSampleTime)+2, std::numeric_limits<uint16_t>::max());
 
     Material mat = decl.visMaterial;
     mat.tex = decl.trlTexture;
@@ -91,6 +130,7 @@ size_t PfxBucket::allocBlock() {
     if(!block[i].allocated) {
       block[i].allocated = true;
       block[i].timeTotal = 0;
+      block[i].expired   = false;
       return i;
       }
     }
@@ -102,11 +142,11 @@ size_t PfxBucket::allocBlock() {
   b.offset    = particles.size();
   b.timeTotal = 0;
 
-  particles.resize(particles.size()+blockSize);
+  particles.resize(particles.size()+blockSize, trlCapacity);
   pfxCpu   .resize(particles.size());
 
   for(size_t i=0; i<blockSize; ++i)
-    particles[b.offset+i].life = 0;
+    finalize(b.offset+i);
   return block.size()-1;
   }
 
@@ -139,7 +179,9 @@ size_t PfxBucket::allocEmitter() {
   for(size_t i=0; i<impl.size(); ++i) {
     auto& b = impl[i];
     if(b.st==S_Free) {
-      b.st = S_Inactive;
+      b.st      = S_Inactive;
+      b.lod     = L_Full;
+      b.lodTime = 0;
       return i;
       }
     }
@@ -184,7 +226,7 @@ bool PfxBucket::shrink() {
     block.pop_back();
     }
   if(particles.size()!=block.size()*blockSize) {
-    particles.resize(block.size()*blockSize);
+    particles.resize(block.size()*blockSize, trlCapacity);
     pfxCpu   .resize(particles.size());
     return true;
     }
@@ -200,66 +242,68 @@ float PfxBucket::randf(float base, float var) {
   }
 
 void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t particle) {
-  auto& p   = particles[particle];
+  auto& life = particles.life[particle];
+  Vec3  pos  = Vec3();
+  Vec3  dir  = Vec3();
 
-  p.life    = uint16_t(randf(decl.lspPartAvg,decl.lspPartVar));
-  p.maxLife = p.life;
+  life = uint16_t(randf(decl.lspPartAvg,decl.lspPartVar));
+  particles.maxLife[particle] = life;
 
   // TODO: pfx.shpDistribType, pfx.shpDistribWalkSpeed;
   switch(decl.shpType) {
     case ParticleFx::EmitterType::Point:{
-      p.pos = Vec3();
+      pos = Vec3();
       break;
       }
     case ParticleFx::EmitterType::Line:{
       float at = randf();
-      p.pos = Vec3(at,at,at);
+      pos = Vec3(at,at,at);
       break;
       }
     case ParticleFx::EmitterType::Box:{
       if(decl.shpIsVolume) {
-        p.pos = Vec3(randf()*2.f-1.f,
+        pos = Vec3(randf()*2.f-1.f,
                      randf()*2.f-1.f,
                      randf()*2.f-1.f);
-        p.pos*=0.5;
+        pos*=0.5;
         } else {
         // TODO
-        p.pos = Vec3(randf()*2.f-1.f,
+        pos = Vec3(randf()*2.f-1.f,
                      randf()*2.f-1.f,
                      randf()*2.f-1.f);
-        p.pos*=0.5;
+        pos*=0.5;
         }
       break;
       }
     case ParticleFx::EmitterType::Sphere:{
       float theta = float(2.0*M_PI)*randf();
       float phi   = std::acos(1.f - 2.f * randf());
-      p.pos = Vec3(std::sin(phi) * std::cos(theta),
+      pos = Vec3(std::sin(phi) * std::cos(theta),
                    std::sin(phi) * std::sin(theta),
                    std::cos(phi));
-      //p.pos*=0.5;
+      //pos*=0.5;
       if(decl.shpIsVolume)
-        p.pos*=randf();
+        pos*=randf();
       break;
       }
     case ParticleFx::EmitterType::Circle:{
       float a = float(2.0*M_PI)*randf();
-      p.pos = Vec3(std::sin(a),
+      pos = Vec3(std::sin(a),
                    0,
                    std::cos(a));
-      //p.pos*=0.5;
+      //pos*=0.5;
       if(decl.shpIsVolume)
-        p.pos = p.pos*std::sqrt(randf());
+        pos = pos*std::sqrt(randf());
       break;
       }
     case ParticleFx::EmitterType::Mesh:{
-      p.pos = Vec3();
+      pos = Vec3();
       auto mesh = (emitter.mesh!=nullptr) ? emitter.mesh : decl.shpMesh;
       auto pose = (emitter.mesh!=nullptr) ? emitter.pose : nullptr;
       if(mesh!=nullptr) {
         auto pos = mesh->randCoord(randf(),pose);
         pos -= emitter.pos;
-        p.pos = emitter.direction[0]*pos.x +
+        pos = emitter.direction[0]*pos.x +
                 emitter.direction[1]*pos.y +
                 emitter.direction[2]*pos.z;
         }
@@ -270,21 +314,21 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
   if(decl.shpType!=ParticleFx::EmitterType::Point &&
      decl.shpType!=ParticleFx::EmitterType::Mesh) {
     Vec3 dim = decl.shpDim*decl.shpScale(block.timeTotal);
-    p.pos.x*=dim.x;
-    p.pos.y*=dim.y;
-    p.pos.z*=dim.z;
+    pos.x*=dim.x;
+    pos.y*=dim.y;
+    pos.z*=dim.z;
     }
 
   switch(decl.shpFOR) {
     case ParticleFx::Frame::Object:
     case ParticleFx::Frame::Node: {
-      p.pos += emitter.direction[0]*decl.shpOffsetVec.x +
+      pos += emitter.direction[0]*decl.shpOffsetVec.x +
                emitter.direction[1]*decl.shpOffsetVec.y +
                emitter.direction[2]*decl.shpOffsetVec.z;
       break;
       }
     case ParticleFx::Frame::World: {
-      p.pos += decl.shpOffsetVec;
+      pos += decl.shpOffsetVec;
       break;
       }
     }
@@ -297,7 +341,7 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
       float dx    = sn * std::cos(theta);
       float dz    = sn * std::sin(theta);
 
-      p.dir       = Vec3(dx,dy,dz);
+      dir       = Vec3(dx,dy,dz);
       break;
       }
     case ParticleFx::Dir::Dir: {
@@ -320,13 +364,13 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
       switch(decl.dirFOR) {
         case ParticleFx::Frame::Object:
         case ParticleFx::Frame::Node: {
-          p.dir = emitter.direction[0]*dx +
+          dir = emitter.direction[0]*dx +
                   emitter.direction[1]*dy +
                   emitter.direction[2]*dz;
           break;
           }
         case ParticleFx::Frame::World: {
-          p.dir = Vec3(dx,dy,dz);
+          dir = Vec3(dx,dy,dz);
           break;
           }
         }
@@ -351,81 +395,161 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
           break;
           }
         }
-      p.dir += targetPos - (emitter.pos+p.pos);
+      dir += targetPos - (emitter.pos+pos);
       break;
     }
 
   if(!decl.useEmittersFOR)
-    p.pos += emitter.pos;
+    pos += emitter.pos;
 
-  auto l = p.dir.length();
+  auto l = dir.length();
   if(l!=0.f) {
     float velocity = randf(decl.velAvg,decl.velVar);
-    p.dir = p.dir*velocity/l;
+    dir = dir*velocity/l;
     }
+  particles.setPos(particle,pos);
+  particles.setDir(particle,dir);
   }
 
 void PfxBucket::finalize(size_t particle) {
-  particles[particle] = {};
-  pfxCpu   [particle] = {};
-  }
-
-void PfxBucket::tick(Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt) {
-  ParState& ps = particles[particle+sys.offset];
-  if(ps.life==0)
-    return;
-
-  if(ps.life<=dt){
-    ps.life = 0;
-    sys.count--;
-    finalize(particle+sys.offset);
-    return;
+  particles.life   [particle] = 0;
+  particles.maxLife[particle] = 1;
+  particles.setPos(particle,Vec3());
+  particles.setDir(particle,Vec3());
+  if(trlCapacity>0) {
+    particles.trlHead[particle] = 0;
+    particles.trlSize[particle] = 0;
+    }
+  pfxCpu[particle] = {};
+  }
+
+bool PfxBucket::advance(size_t particle, uint64_t dt) {
+  auto& life = particles.life[particle];
+  if(life<=dt) {
+    finalize(particle);
+    return false;
+    }
+
+  const float t = float(dt);
+  life = uint16_t(life-dt);
+  particles.setPos(particle, particles.pos(particle) + particles.dir(particle)*t + decl.flyGravity*(0.5f*t*t));
+  particles.setDir(particle, particles.dir(particle) + decl.flyGravity*t);
+  if(trlCapacity>0)
+    particles.trlSize[particle] = 0;
+  return true;
+  }
+
+void PfxBucket::tick(Block& sys, ImplEmitter& emitter, uint64_t dt) {
+  const size_t begin = sys.offset;
+  const size_t end   = sys.offset+blockSize;
+  const float  dtF   = float(dt);
+  const Vec3   dv    = decl.flyGravity*dtF;
+
+  uint16_t* life = particles.life.data();
+  float*    px   = particles.posX.data();
+  float*    py   = particles.posY.data();
+  float*    pz   = particles.posZ.data();
+  float*    dx   = particles.dirX.data();
+  float*    dy   = particles.dirY.data();
+  float*    dz   = particles.dirZ.data();
+
+  for(size_t i=begin; i<end; ++i) {
+    if(life[i]==0)
+      continue;
+    if(life[i]<=dt) {
+      sys.count--;
+      finalize(i);
+      continue;
+      }
+    life[i] = uint16_t(life[i]-dt);
     }
 
-  const float dtF = float(dt);
-
-  // eval particle
-  ps.life  = uint16_t(ps.life-dt);
-  ps.pos  += ps.dir*dtF;
-  ps.dir  += decl.flyGravity*dtF;
+  // branch-free and one stream pair per loop, to let compiler vectorize it; dead particles are reset in init
+  for(size_t i=begin; i<end; ++i) {
+    px[i] += dx[i]*dtF;
+    dx[i] += dv.x;
+    }
+  for(size_t i=begin; i<end; ++i) {
+    py[i] += dy[i]*dtF;
+    dy[i] += dv.y;
+    }
+  for(size_t i=begin; i<end; ++i) {
+    pz[i] += dz[i]*dtF;
+    dz[i] += dv.z;
+    }
 
-  if(maxTrlTime!=0)
-    tickTrail(ps,emitter,dt);
+  if(maxTrlTime!=0) {
+    for(size_t i=begin; i<end; ++i)
+      if(life[i]!=0)
+        tickTrail(i,emitter,dt);
+    }
   }
 
-void PfxBucket::tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt) {
-  for(auto& i:ps.trail)
-    i.time+=dt;
+void PfxBucket::tickTrail(size_t particle, ImplEmitter& emitter, uint64_t dt) {
+  Trail*    ring = &particles.trail[particle*trlCapacity];
+  uint16_t& head = particles.trlHead[particle];
+  uint16_t& size = particles.trlSize[particle];
+
+  for(size_t i=0; i<size; ++i)
+    ring[(head+i)%trlCapacity].time+=dt;
 
   Trail tx;
   if(decl.useEmittersFOR)
-    tx.pos = ps.pos + emitter.pos; else
-    tx.pos = ps.pos;
-
-  if(ps.trail.size()==0) {
-    ps.trail.push_back(tx);
-    }
-  else if(ps.trail.back().pos!=tx.pos) {
-    bool extrude = false;
-    if(false && ps.trail.size()>1) {
-      auto u = tx.pos              - ps.trail[ps.trail.size()-2].pos;
-      auto v = ps.trail.back().pos - ps.trail[ps.trail.size()-2].pos;
-      if(std::abs(Vec3::dotProduct(u,v)-u.length()*v.length()) < 0.001f)
-        extrude = true;
+    tx.pos = particles.pos(particle) + emitter.pos; else
+    tx.pos = particles.pos(particle);
+
+  if(size==0) {
+    ring[head] = tx;
+    size = 1;
+    }
+  else if(ring[(head+size-1)%trlCapacity].pos!=tx.pos) {
+    if(size>=2 && ring[(head+size-2)%trlCapacity].time<trlSampleTime) {
+      // sample rate is higher than needed - move last point instead of adding a new one
+      ring[(head+size-1)%trlCapacity] = tx;
+      }
+    else {
+      if(size==trlCapacity) {
+        head = uint16_t((head+1)%trlCapacity);
+        --size;
+        }
+      ring[(head+size)%trlCapacity] = tx;
+      ++size;
       }
-    if(extrude)
-      ps.trail.back() = tx; else
-      ps.trail.push_back(tx);
     }
   else {
-    ps.trail.back().time = 0;
+    ring[(head+size-1)%trlCapacity].time = 0;
     }
 
-  for(size_t rm=0; rm<=ps.trail.size(); ++rm) {
-    if(rm==ps.trail.size() || ps.trail[rm].time<maxTrlTime) {
-      ps.trail.erase(ps.trail.begin(),ps.trail.begin()+int(rm));
-      break;
-      }
+  while(size>0 && ring[head].time>=maxTrlTime) {
+    head = uint16_t((head+1)%trlCapacity);
+    --size;
+    }
+  }
+
+const PfxBucket::Trail& PfxBucket::trail(size_t particle, size_t i) const {
+  return particles.trail[particle*trlCapacity + (particles.trlHead[particle]+i)%trlCapacity];
+  }
+
+void PfxBucket::tickParticles(uint64_t dt, size_t emBegin, size_t emEnd) {
+  if(decl.isDecal())
+    return;
+
+  emEnd = std::min(emEnd, impl.size());
+  for(size_t id=emBegin; id<emEnd; ++id) {
+    auto& emitter = impl[id];
+    if(emitter.st==S_Free)
+      continue;
+
+    emitter.lodTime += dt;
+    emitter.lodStep  = (emitter.lod==L_Full) || (emitter.lod==L_Reduced && emitter.lodTime>=parent.lodUpdateTime);
+    if(!emitter.lodStep || emitter.block==size_t(-1))
+      continue;
+
+    auto& p = block[emitter.block];
+    if(p.count==0)
+      continue;
+    tick(p,emitter,emitter.lodTime);
+    p.expired = (p.count==0);
     }
   }
 
@@ -437,9 +561,27 @@ void PfxBucket::tick(uint64_t dt, const Vec3& viewPos) {
   implTickCommon(dt,viewPos);
   }
 
+void PfxBucket::tickSpawn() {
+  // creation of PfxEmitter may allocate in any bucket, including this one
+  for(auto id:spawnQueue) {
+    if(id>=impl.size() || impl[id].st!=S_Active || impl[id].next!=nullptr)
+      continue;
+    const auto pos    = impl[id].pos;
+    const bool isLoop = impl[id].isLoop;
+
+    std::unique_ptr<PfxEmitter> next(new PfxEmitter(parent,decl.ppsCreateEm));
+    next->setPosition(pos.x,pos.y,pos.z);
+    next->setActive(true);
+    next->setLooped(isLoop);
+    impl[id].next = std::move(next);
+    }
+  spawnQueue.clear();
+  }
+
 void PfxBucket::implTickCommon(uint64_t dt, const Vec3& viewPos) {
   bool doShrink = false;
-  for(auto& emitter:impl) {
+  for(size_t id=0; id<impl.size(); ++id) {
+    auto& emitter = impl[id];
     if(emitter.st==S_Free)
       continue;
 
@@ -447,41 +589,61 @@ void PfxBucket::implTickCommon(uint64_t dt, const Vec3& viewPos) {
     const bool nearby = (dp.quadLength()<PfxObjects::viewRage*PfxObjects::viewRage);
 
     if(emitter.next==nullptr && decl.ppsCreateEm!=nullptr && emitter.waitforNext<dt && emitter.st==S_Active) {
-      emitter.next.reset(new PfxEmitter(parent,decl.ppsCreateEm));
-      auto& e = *emitter.next;
-      e.setPosition(emitter.pos.x,emitter.pos.y,emitter.pos.z);
-      e.setActive(true);
-      e.setLooped(emitter.isLoop);
+      // deferred to tickSpawn
+      spawnQueue.push_back(id);
       }
 
     if(emitter.waitforNext>=dt)
       emitter.waitforNext-=dt;
 
+    const Lod lod = evalLod(emitter,nearby);
+
     if(emitter.block!=size_t(-1)) {
       auto& p = getBlock(emitter);
-      if(p.count>0) {
-        for(size_t i=0;i<blockSize;++i)
-          tick(p,emitter,i,dt);
-        if(p.count==0 && (emitter.st==S_Fade || !nearby)) {
+      if(p.expired) {
+        p.expired = false;
+        if(emitter.st==S_Fade || !nearby) {
           // free mem
           freeBlock(emitter.block);
           if(emitter.st==S_Fade)
             emitter.st = S_Free;
+          emitter.lod     = lod;
+          emitter.lodTime = 0;
           doShrink = true;
           continue;
           }
         }
       }
 
+    if(emitter.lod==L_Sleep && lod!=L_Sleep) {
+      wakeUp(emitter, emitter.st==S_Active && nearby);
+      emitter.lod     = lod;
+      emitter.lodTime = 0;
+      continue;
+      }
+
+    emitter.lod = lod;
+    if(!emitter.lodStep)
+      continue;
+
+    const uint64_t step = emitter.lodTime;
+    emitter.lodTime = 0;
+
     if(emitter.st==S_Active && nearby) {
       auto& p = getBlock(emitter);
-      auto dE = ppsDiff(decl,emitter.isLoop,p.timeTotal,p.timeTotal+dt);
+      auto dE = ppsDiff(decl,emitter.isLoop,p.timeTotal,p.timeTotal+step);
+      if(lod==L_Reduced) {
+        const float e = float(dE)*parent.lodPpsScale;
+        dE = uint64_t(e);
+        if(randf()<e-float(dE))
+          ++dE;
+        }
       tickEmit(p,emitter,dE);
       }
 
     if(emitter.block!=size_t(-1)) {
       auto& p = getBlock(emitter);
-      p.timeTotal+=dt;
+      p.timeTotal+=step;
       }
     }
 
@@ -501,7 +663,7 @@ void PfxBucket::implTickDecals(uint64_t, const Vec3&) {
       } else
     if(emitter.st==S_Fade) {
       for(size_t i=0; i<blockSize; ++i)
-        particles[p.offset+i].life = 0;
+        finalize(p.offset+i);
       p.count = 0;
       freeBlock(emitter.block);
       emitter.st = S_Free;
@@ -509,16 +671,59 @@ void PfxBucket::implTickDecals(uint64_t, const Vec3&) {
     }
   }
 
-void PfxBucket::tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited) {
+PfxBucket::Lod PfxBucket::evalLod(const ImplEmitter& emitter, bool nearby) const {
+  if(!parent.lodEnabled || !nearby)
+    return L_Full;
+
+  auto& fr = parent.scene.frustrum[SceneGlobals::V_Main];
+  if(!fr.testPoint(emitter.pos, lodRadius)) {
+    // only active emitters can sleep, rest must finish theirs particles
+    return emitter.st==S_Active ? L_Sleep : L_Reduced;
+    }
+
+  // approximate size on screen, in pixels
+  const float dist = (emitter.pos-parent.viewerPos).length();
+  const float px   = lodRadius*float(fr.height)/std::max(dist,1.f);
+  return px<parent.lodScreenSize ? L_Reduced : L_Full;
+  }
+
+void PfxBucket::wakeUp(ImplEmitter& emitter, bool emit) {
+  // fast-forward emitter, as if it was simulated all the time
+  const uint64_t dt = emitter.lodTime;
+  if(emitter.block==size_t(-1) && !emit)
+    return;
+
+  auto& p = getBlock(emitter);
+  for(size_t i=p.offset; i<p.offset+blockSize; ++i) {
+    if(particles.life[i]==0)
+      continue;
+    if(!advance(i,dt))
+      p.count--;
+    }
+
+  if(emit) {
+    // particles, emitted during last lifetime-window, are spread uniformly by age
+    const uint64_t window = std::min(dt, decl.maxLifetime());
+    const uint64_t time1  = p.timeTotal+dt;
+    tickEmit(p,emitter,ppsDiff(decl,emitter.isLoop,time1-window,time1),window);
+    }
+  p.timeTotal += dt;
+  // tickParticles skips empty blocks - block has to be marked here, to be freed
+  p.expired = (p.count==0);
+  }
+
+void PfxBucket::tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited, uint64_t maxAge) {
   size_t lastI = 0;
   for(size_t id=1; emited>0; ++id) {
-    const size_t i  = id%blockSize;
-    ParState&    ps = particles[i+p.offset];
-    if(ps.life==0) { // free slot
+    const size_t i    = id%blockSize;
+    uint16_t&    life = particles.life[i+p.offset];
+    if(life==0) { // free slot
       --emited;
       lastI = i;
       init(p,emitter,i+p.offset);
-      if(ps.life==0)
+      if(life==0)
+        continue;
+      if(maxAge>0 && !advance(i+p.offset, uint64_t(randf()*float(maxAge))))
         continue;
       p.count++;
       } else {
@@ -529,9 +734,7 @@ void PfxBucket::tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited) {
     }
   }
 
-void PfxBucket::buildSsbo() {
-  buildSsboTrails();
-
+void PfxBucket::buildSsbo(size_t blBegin, size_t blEnd) {
   auto  colorS          = decl.visTexColorStart;
   auto  colorE          = decl.visTexColorEnd;
   auto  visSizeStart    = decl.visSizeStart;
@@ -540,20 +743,21 @@ void PfxBucket::buildSsbo() {
   auto  visAlphaEnd     = decl.visAlphaEnd;
   auto  visAlphaFunc    = decl.visMaterial.alpha;
 
-  for(auto& p:block) {
+  blEnd = std::min(blEnd, block.size());
+  for(size_t id=blBegin; id<blEnd; ++id) {
+    auto& p = block[id];
     if(p.count==0)
       continue;
 
-    for(size_t pId=0; pId<blockSize; ++pId) {
-      ParState& ps = particles[pId+p.offset];
-      auto&     px = pfxCpu   [pId+p.offset];
+    for(size_t pId=p.offset; pId<p.offset+blockSize; ++pId) {
+      auto& px = pfxCpu[pId];
 
-      if(ps.life==0) {
+      if(particles.life[pId]==0) {
         px.size = Vec3();
         continue;
         }
 
-      const float a     = ps.lifeTime();
+      const float a     = particles.lifeTime(pId);
       const Vec3  cl    = colorS*(1.f-a)        + colorE*a;
       const float clA   = visAlphaStart*(1.f-a) + visAlphaEnd*a;
 
@@ -582,11 +786,23 @@ void PfxBucket::buildSsbo() {
         }
       uint32_t colorU32;
       std::memcpy(&colorU32,&color,4);
-      buildBilboard(px,p,ps, colorU32, szX,szY,szZ);
+      buildBilboard(px,p,particles.pos(pId),particles.dir(pId), colorU32, szX,szY,szZ);
       }
     }
   }
 
+void PfxBucket::collectStats(PfxObjects::Stats& st) const {
+  for(auto& i:block)
+    st.particles += i.count;
+  for(auto& i:impl) {
+    if(i.st==S_Free)
+      continue;
+    st.emitters++;
+    if(i.lod==L_Sleep)
+      st.sleeping++;
+    }
+  }
+
 void PfxBucket::buildSsboTrails() {
   if(!decl.hasTrails())
     return;
@@ -594,26 +810,27 @@ void PfxBucket::buildSsboTrails() {
   trlCpu.reserve(trlCpu.size());
   trlCpu.clear();
 
-  for(auto& p:particles) {
-    if(p.life==0)
+  for(size_t i=0; i<particles.size(); ++i) {
+    if(particles.life[i]==0)
       continue;
-    if(p.trail.size()<2)
+    const size_t size = particles.trlSize[i];
+    if(size<2)
       continue;
 
-    float maxT = float(std::min(maxTrlTime,p.trail[0].time));
-    for(size_t r=1; r<p.trail.size(); ++r) {
+    float maxT = float(std::min(maxTrlTime,trail(i,0).time));
+    for(size_t r=1; r<size; ++r) {
       PfxState st;
-      buildTrailSegment(st,p.trail[r-1],p.trail[r],maxT);
+      buildTrailSegment(st,trail(i,r-1),trail(i,r),maxT);
       trlCpu.push_back(st);
       }
     }
   }
 
-void PfxBucket::buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
-                              float szX, float szY, float szZ) {
+void PfxBucket::buildBilboard(PfxState& v, const Block& p, const Vec3& pos, const Vec3& dir,
+                              const uint32_t color, float szX, float szY, float szZ) {
   if(decl.useEmittersFOR)
-    v.pos = ps.pos + p.pos; else
-    v.pos = ps.pos;
+    v.pos = pos + p.pos; else
+    v.pos = pos;
 
   v.size  = Vec3(szX,szY,szZ);
   v.color = color;
@@ -623,7 +840,7 @@ void PfxBucket::buildBilboard(PfxState& v, const Block& p, const ParState& ps, c
   v.bits0 |= uint32_t(decl.visYawAlign ? 1 : 0) << 2;
   v.bits0 |= uint32_t(0) << 3; // TODO: trails
   v.bits0 |= uint32_t(decl.visOrientation) << 4;
-  v.dir   = ps.dir;
+  v.dir   = dir;
   }
 
 void PfxBucket::buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT) {
@@ -24,6 +24,12 @@ class PfxBucket {
       S_Active,
       };
 
+    enum Lod: uint8_t {
+      L_Full,
+      L_Reduced,
+      L_Sleep,
+      };
+
     struct ImplEmitter final {
       AllocState    st           = S_Free;
       size_t        block        = size_t(-1);
@@ -39,6 +45,10 @@ class PfxBucket {
 
       uint64_t      waitforNext = 0;
       std::unique_ptr<PfxEmitter> next;
+
+      Lod           lod         = L_Full;
+      bool          lodStep     = false;
+      uint64_t      lodTime     = 0; // not simulated yet
       };
 
     struct PfxState {
@@ -64,8 +74,18 @@ class PfxBucket {
     void                        freeEmitter(size_t& id);
 
     ImplEmitter&                get(size_t id) { return impl[id]; }
+    size_t                      emitterCount()  const { return impl.size();  }
+    size_t                      blockCount()    const { return block.size(); }
+    size_t                      particlesPerBlock() const { return blockSize; }
+
+    // thread-safe across different buckets and non-overlapping ranges of the same bucket
+    void                        tickParticles(uint64_t dt, size_t emBegin, size_t emEnd);
+    // thread-safe across different buckets
     void                        tick(uint64_t dt, const Tempest::Vec3& viewPos);
-    void                        buildSsbo();
+    void                        tickSpawn();
+    void                        buildSsbo(size_t blBegin, size_t blEnd);
+    void                        buildSsboTrails();
+    void                        collectStats(PfxObjects::Stats& st) const;
 
   private:
     enum UboLinkpackage : uint8_t {
@@ -92,6 +112,7 @@ class PfxBucket {
 
       size_t        offset    = 0;
       size_t        count     = 0;
+      bool          expired   = false;
 
       Tempest::Vec3 pos       = {};
       };
@@ -101,13 +122,23 @@ class PfxBucket {
       uint64_t      time = 0;
       };
 
-    struct ParState final {
-      uint16_t      life=0, maxLife=1;
-      Tempest::Vec3 pos, dir;
+    // structure of arrays, one array per component; trails are fixed-size ring buffers, trlCapacity entries per particle
+    struct Particles final {
+      std::vector<uint16_t>      life, maxLife;
+      std::vector<float>         posX, posY, posZ;
+      std::vector<float>         dirX, dirY, dirZ;
+
+      std::vector<Trail>         trail;
+      std::vector<uint16_t>      trlHead, trlSize;
 
-      std::vector<Trail> trail;
+      size_t        size() const { return life.size(); }
+      void          resize(size_t sz, size_t trlCapacity);
+      float         lifeTime(size_t i) const;
 
-      float         lifeTime() const;
+      Tempest::Vec3 pos(size_t i) const { return Tempest::Vec3(posX[i],posY[i],posZ[i]); }
+      Tempest::Vec3 dir(size_t i) const { return Tempest::Vec3(dirX[i],dirY[i],dirZ[i]); }
+      void          setPos(size_t i, const Tempest::Vec3& v) { posX[i] = v.x; posY[i] = v.y; posZ[i] = v.z; }
+      void          setDir(size_t i, const Tempest::Vec3& v) { dirX[i] = v.x; dirY[i] = v.y; dirZ[i] = v.z; }
       };
 
     struct Draw {
@@ -123,29 +154,32 @@ class PfxBucket {
     void                        drawCommon(Tempest::Encoder<Tempest::CommandBuffer>& cmd, const SceneGlobals &scene, const Draw& itm,
                                            SceneGlobals::VisCamera view, Material::AlphaFunc func, bool trl);
 
-    void                        tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited);
+    void                        tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited, uint64_t maxAge = 0);
+    Lod                         evalLod(const ImplEmitter& emitter, bool nearby) const;
+    void                        wakeUp(ImplEmitter& emitter, bool emit);
     bool                        shrink();
 
     size_t                      allocBlock();
     void                        freeBlock(size_t& s);
 
-    static float                randf();
-    static float                randf(float base, float var);
+    float                       randf();
+    float                       randf(float base, float var);
 
     Block&                      getBlock(ImplEmitter& emitter);
     Block&                      getBlock(PfxEmitter&  emitter);
 
     void                        init     (Block& block, ImplEmitter& emitter, size_t particle);
     void                        finalize (size_t particle);
-    void                        tick     (Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt);
-    void                        tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt);
+    bool                        advance  (size_t particle, uint64_t dt);
+    void                        tick     (Block& sys, ImplEmitter& emitter, uint64_t dt);
+    void                        tickTrail(size_t particle, ImplEmitter& emitter, uint64_t dt);
+    const Trail&                trail(size_t particle, size_t i) const;
 
     void                        implTickCommon(uint64_t dt, const Tempest::Vec3& viewPos);
     void                        implTickDecals(uint64_t dt, const Tempest::Vec3& viewPos);
 
-    void                        buildSsboTrails();
-    void                        buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
-                                              float szX, float szY, float szZ);
+    void                        buildBilboard(PfxState& v, const Block& p, const Tempest::Vec3& pos, const Tempest::Vec3& dir,
+                                              const uint32_t color, float szX, float szY, float szZ);
     void                        buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT);
     uint32_t                    mkTrailColor(float clA) const;
 
@@ -157,15 +191,21 @@ class PfxBucket {
     Draw                        itemTrl[Resources::MaxFramesInFlight];
     std::vector<PfxState>       trlCpu;
 
-    uint64_t                    maxTrlTime = 0;
-    size_t                      blockSize = 0;
+    uint64_t                    maxTrlTime  = 0;
+    size_t                      trlCapacity = 0;
+    size_t                      blockSize   = 0;
+    float                       lodRadius   = 0;
+
+    static constexpr uint64_t   trlSampleTime  = 10;
 
-    std::vector<ParState>       particles;
+    Particles                   particles;
     std::vector<ImplEmitter>    impl;
     std::vector<Block>          block;
     bool                        forceUpdate[Resources::MaxFramesInFlight] = {};
+    std::vector<size_t>         spawnQueue;
 
-    static std::mt19937         rndEngine;
+    // per bucket: emission runs one task per bucket, so stream doesn't depend on thread scheduling
+    std::mt19937                rndEngine;
 
     friend class PfxEmitter;
   };
@@ -2,8 +2,13 @@
 
 #include <Tempest/Log>
 #include <cstring>
+#include <atomic>
+#include <chrono>
 
 #include "graphics/sceneglobals.h"
+#include "utils/profiler.h"
+#include "utils/workers.h"
+#include "gothic.h"
 
 #include "pfxbucket.h"
 #include "particlefx.h"
@@ -12,9 +17,19 @@ using namespace Tempest;
 
 PfxObjects::PfxObjects(WorldView& world, const SceneGlobals& scene, VisualObjects& visual)
   :world(world), scene(scene), visual(visual) {
+  Gothic::inst().onSettingsChanged.bind(this,&PfxObjects::setupSettings);
+  setupSettings();
   }
 
 PfxObjects::~PfxObjects() {
+  Gothic::inst().onSettingsChanged.ubind(this,&PfxObjects::setupSettings);
+  }
+
+void PfxObjects::setupSettings() {
+  lodEnabled    = Gothic::settingsGetI("ENGINE","pfxLod")!=0;
+  lodScreenSize = float(Gothic::settingsGetI("ENGINE","pfxLodScreenSize"));
+  lodUpdateTime = uint64_t(std::max(0, Gothic::settingsGetI("ENGINE","pfxLodUpdateTime")));
+  lodPpsScale   = std::clamp(Gothic::settingsGetF("ENGINE","pfxLodPpsScale"), 0.f, 1.f);
   }
 
 void PfxObjects::setViewerPos(const Vec3& pos) {
@@ -25,7 +40,39 @@ void PfxObjects::resetTicks() {
   lastUpdate = size_t(-1);
   }
 
+void PfxObjects::mkTasks(size_t (PfxBucket::*count)() const) {
+  tasks.clear();
+  for(auto& i:bucket) {
+    const size_t cnt  = (i.*count)();
+    const size_t step = std::max<size_t>(1, particlesPerTask/i.particlesPerBlock());
+    for(size_t b=0; b<cnt; b+=step)
+      tasks.push_back({&i,b,b+step});
+    }
+  }
+
+template<class F>
+void PfxObjects::runTasks(const F& func) {
+  const size_t maxThreads = threadLimit>0 ? threadLimit : Workers::maxThreads();
+  if(tasks.size()<=1 || maxThreads<=1) {
+    for(auto& i:tasks)
+      func(i);
+    return;
+    }
+
+  std::atomic_size_t next{0};
+  const size_t       thCount = std::min<size_t>(maxThreads, tasks.size());
+  Workers::parallelTasks(thCount,[this,&next,&func](size_t) {
+    while(true) {
+      const size_t id = next.fetch_add(1);
+      if(id>=tasks.size())
+        break;
+      func(tasks[id]);
+      }
+    });
+  }
+
 void PfxObjects::tick(uint64_t ticks) {
+  PROFILE_SCOPE("PfxObjects::tick");
   static bool disabled = false;
   if(disabled)
     return;
@@ -39,13 +86,64 @@ void PfxObjects::tick(uint64_t ticks) {
   if(dt==0)
     return;
 
+  implTick(dt);
+  lastUpdate = ticks;
+  }
+
+auto PfxObjects::benchmarkScaling(uint64_t dt, uint32_t iterations) -> std::vector<ScalingSample> {
+  std::vector<ScalingSample> ret;
+  const size_t maxThreads = std::max<size_t>(1, Workers::maxThreads());
+  for(size_t th=1; ; th = std::min(th*2, maxThreads)) {
+    threadLimit = th;
+    size_t     particles = 0;
+    const auto begin     = std::chrono::steady_clock::now();
+    for(uint32_t i=0; i<iterations; ++i) {
+      implTick(dt);
+      particles += stat.particles;
+      }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ms = std::chrono::duration<double,std::milli>(end-begin).count();
+    ScalingSample s;
+    s.threads        = th;
+    s.tickMs         = ms/std::max(1u,iterations);
+    s.particlesPerMs = ms>0 ? double(particles)/ms : 0;
+    ret.push_back(s);
+    if(th==maxThreads)
+      break;
+    }
+  threadLimit = 0;
+  return ret;
+  }
+
+void PfxObjects::implTick(uint64_t dt) {
+  // particle integration: independent per emitter
+  mkTasks(&PfxBucket::emitterCount);
+  runTasks([dt](Task& t){
+    t.bucket->tickParticles(dt,t.begin,t.end);
+    });
+
+  // emission and memory management: independent per bucket
+  tasks.clear();
   for(auto& i:bucket)
-    i.tick(dt,viewerPos);
+    tasks.push_back({&i,0,0});
+  runTasks([this,dt](Task& t){
+    t.bucket->tick(dt,viewerPos);
+    t.bucket->buildSsboTrails();
+    });
 
+  // ppsCreateEm touches other buckets
   for(auto& i:bucket)
-    i.buildSsbo();
+    i.tickSpawn();
 
-  lastUpdate = ticks;
+  mkTasks(&PfxBucket::blockCount);
+  runTasks([](Task& t){
+    t.bucket->buildSsbo(t.begin,t.end);
+    });
+
+  stat = Stats();
+  for(auto& i:bucket)
+    i.collectStats(stat);
   }
 
 bool PfxObjects::isInPfxRange(const Vec3& pos) const {
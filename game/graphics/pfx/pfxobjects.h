@@ -21,11 +21,26 @@ class PfxObjects final {
 
     static constexpr const float viewRage = 4000.f;
 
+    struct Stats {
+      size_t particles = 0;
+      size_t emitters  = 0;
+      size_t sleeping  = 0;
+      };
+
+    struct ScalingSample {
+      size_t threads        = 0;
+      double tickMs         = 0;
+      double particlesPerMs = 0;
+      };
+
     void       setViewerPos(const Tempest::Vec3& pos);
 
     void       resetTicks();
     void       tick(uint64_t ticks);
     bool       isInPfxRange(const Tempest::Vec3& pos) const;
+    Stats      stats() const { return stat; }
+    // ticks all buckets with 1,2,4...max worker threads; particles are fast-forwarded by dt on each iteration
+    auto       benchmarkScaling(uint64_t dt, uint32_t iterations) -> std::vector<ScalingSample>;
 
     void       preFrameUpdate(uint8_t fId);
 
@@ -41,6 +56,21 @@ class PfxObjects final {
       std::unique_ptr<ParticleFx> pfx;
       };
 
+    struct Task {
+      PfxBucket* bucket = nullptr;
+      size_t     begin  = 0;
+      size_t     end    = 0;
+      };
+
+    static constexpr const size_t particlesPerTask = 2048;
+
+    void                          setupSettings();
+    void                          implTick(uint64_t dt);
+
+    void                          mkTasks(size_t (PfxBucket::*count)() const);
+    template<class F>
+    void                          runTasks(const F& func);
+
     PfxBucket&                    getBucket(const ParticleFx& decl);
     PfxBucket&                    getBucket(const Material& mat, const zenkit::VirtualObject& vob);
 
@@ -51,10 +81,20 @@ class PfxObjects final {
 
     std::list<PfxBucket>          bucket;
     std::vector<SpriteEmitter>    spriteEmit;
+    std::vector<Task>             tasks;
 
     Tempest::Vec3                 viewerPos={};
     uint64_t                      lastUpdate=0;
+    Stats                         stat;
+    size_t                        threadLimit = 0; // 0 - all workers
+    uint32_t                      bucketSeq   = 0;
+
+    bool                          lodEnabled    = true;
+    float                         lodScreenSize = 48;
+    uint64_t                      lodUpdateTime = 50;
+    float                         lodPpsScale   = 0.5f;
 
+  friend class PfxBucket;
   friend class PfxEmitter;
   friend class TrlObjects;
   };
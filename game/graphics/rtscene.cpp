@@ -122,6 +122,20 @@ void RtScene::buildTlas() {
   rtDesc = device.ssbo(build.rtDesc);
   tlas   = device.tlas(build.inst);
 
+  texList       = std::move(build.tex);
+  texGeneration = Resources::textureGeneration();
   build = Build();
   }
 
+bool RtScene::updateTextures() {
+  const uint32_t gen = Resources::textureGeneration();
+  if(gen==texGeneration)
+    return false;
+  texGeneration = gen;
+  if(texList.empty())
+    return false;
+  Resources::recycle(std::move(tex));
+  tex = Resources::device().descriptors(texList);
+  return true;
+  }
+
@@ -178,6 +178,11 @@ void SceneGlobals::setTime(uint64_t time) {
   if(zWindEnabled)
     windDir = Tempest::Vec2(0.f,1.f)*1.f; else
     windDir = Tempest::Vec2(0,0);
+
+  // per-object sway is evaluated in vertex shader, see windShear in scene.glsl
+  const float ax = float(tickCount%windPeriod)/float(windPeriod);
+  uboGlobalCpu.windPhase = (ax*2.f-1.f)*float(M_PI);
+  uboGlobalCpu.windDir   = windDir;
   }
 
 void SceneGlobals::commitUbo(uint8_t fId) {
@@ -273,6 +278,10 @@ const Tempest::Vec3 SceneGlobals::clipInfo() const {
   return uboGlobalCpu.clipInfo;
   }
 
+const Tempest::Vec3 SceneGlobals::camPos() const {
+  return uboGlobalCpu.camPos;
+  }
+
 const Tempest::Matrix4x4 SceneGlobals::viewProjectLwc() const {
   auto m = proj;
   m.mul(viewLwc);
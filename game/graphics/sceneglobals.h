@@ -54,6 +54,7 @@ class SceneGlobals final {
     const Tempest::Matrix4x4& viewProjectInv() const;
     const Tempest::Matrix4x4& viewShadow(uint8_t view) const;
     const Tempest::Vec3       clipInfo() const;
+    const Tempest::Vec3       camPos() const;
 
     const Tempest::Matrix4x4  viewProjectLwc() const;
     const Tempest::Matrix4x4  viewProjectLwcInv() const;
@@ -120,6 +121,8 @@ class SceneGlobals final {
       Tempest::Vec2                   cloudsDir[2] = {};
 
       float                           probeGridBias = 3;
+      float                           windPhase = 0;
+      Tempest::Vec2                   windDir   = {};
       };
 
     Tempest::UniformBuffer<UboGlobal> uboGlobalPf[Resources::MaxFramesInFlight][V_Count];
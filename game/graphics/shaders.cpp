@@ -314,6 +314,8 @@ void Shaders::compileShaders() {
   }
 
 bool Shaders::isVsmSupported() {
+  if(Resources::isHeadless())
+    return false;
   auto& gpu = Resources::device().properties();
   if(gpu.compute.maxInvocations>=1024 && gpu.render.maxClipCullDistances>=4 &&
      gpu.render.maxViewportSize.w>=8192 && gpu.render.maxViewportSize.h>=8192) {
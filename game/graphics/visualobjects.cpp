@@ -30,16 +30,20 @@ struct VisualObjects::InstanceDesc {
   float    pos[4][3] = {};
   float    fatness   = 0;
   uint32_t animPtr   = 0;
-  uint32_t padd0     = {};
+  float    wind      = 0;
   uint32_t padd1     = {};
   };
 
+// static description of morph-layer; current frame is resolved on GPU from tickCount32
 struct VisualObjects::MorphDesc final {
-  uint32_t indexOffset = 0;
-  uint32_t sample0     = 0;
-  uint32_t sample1     = 0;
-  uint16_t alpha       = 0;
-  uint16_t intensity   = 0;
+  uint32_t indexOffset     = 0;
+  uint32_t samplesPerFrame = 0;
+  uint32_t tickPerFrame    = 1;
+  uint32_t numFrames       = 1;
+  uint32_t timeStart       = 0;
+  uint32_t timeUntil       = 0; // uint32_t(-1) - infinite
+  float    intensity       = 0;
+  uint32_t padd0           = 0;
   };
 
 struct VisualObjects::MorphData {
@@ -54,6 +58,9 @@ void VisualObjects::Item::setObjMatrix(const Tempest::Matrix4x4& pos) {
       owner->updateRtAs(id);
     obj.pos = pos;
     owner->updateInstance(id);
+    // texture may still be in flight: objects near the camera are decoded first
+    auto npos = Vec3(pos[3][0], pos[3][1], pos[3][2]);
+    Resources::prioritizeTexture(obj.bucketId->mat.tex, (npos-owner->scene.camPos()).quadLength());
     }
   }
 
@@ -83,18 +90,12 @@ void VisualObjects::Item::setWind(zenkit::AnimationType m, float intensity) {
     m = zenkit::AnimationType::NONE;
 
   auto& obj = owner->objects[id];
+  if(obj.wind==m && obj.windIntensity==intensity)
+    return;
 
-  const auto prev = obj.wind;
   obj.wind          = m;
   obj.windIntensity = intensity;
-
-  if(prev==m)
-    return;
-
-  if(prev!=zenkit::AnimationType::NONE)
-    owner->objectsWind.erase(id);
-  if(m!=zenkit::AnimationType::NONE)
-    owner->objectsWind.insert(id);
+  owner->updateInstance(id);
   }
 
 void VisualObjects::Item::startMMAnim(std::string_view anim, float intensity, uint64_t timeUntil) {
@@ -146,21 +147,39 @@ std::pair<uint32_t, uint32_t> VisualObjects::Item::meshSlice() const {
 
 VisualObjects::VisualObjects(const SceneGlobals& scene, const std::pair<Vec3, Vec3>& bbox)
     : scene(scene), drawCmd(*this, bucketsMem, clustersMem, scene) {
-  objectsMorph.reserve(1024);
   }
 
 VisualObjects::~VisualObjects() {
   }
 
-void VisualObjects::updateInstance(size_t id, Matrix4x4* pos) {
+float VisualObjects::windAmplitude(const Object& obj) {
+  switch(obj.wind) {
+    case zenkit::AnimationType::WIND:
+      // tree. note: mods tent to bump Intensity to insane values
+      if(obj.windIntensity>0.f)
+        return 0.03f;
+      return 0;
+    case zenkit::AnimationType::WIND_ALT:
+      // grass
+      if(obj.windIntensity>0.f && obj.windIntensity<=1.0)
+        return obj.windIntensity * 0.1f;
+      return 0;
+    case zenkit::AnimationType::NONE:
+    default:
+      return 0;
+    }
+  }
+
+void VisualObjects::updateInstance(size_t id) {
   auto& obj = objects[id];
   if(obj.type==DrawCommands::Landscape)
     return;
 
   InstanceDesc d;
-  d.setPosition(pos==nullptr ? obj.pos : *pos);
+  d.setPosition(obj.pos);
   d.animPtr = obj.animPtr;
   d.fatness = obj.fatness*0.5f;
+  d.wind    = windAmplitude(obj);
   obj.objInstance.set(&d, 0, sizeof(d));
 
   auto cId  = obj.clusterId;
@@ -323,11 +342,6 @@ void VisualObjects::free(size_t id) {
   drawCmd.addClusters(obj.cmdId, -meshletCount);
   clustersMem.free(obj.clusterId, numCluster);
 
-  if(obj.wind==zenkit::AnimationType::NONE)
-    objectsWind.erase(id);
-  if(obj.type==DrawCommands::Morph)
-    objectsMorph.erase(id);
-
   obj = Object();
   while(objects.size()>0) {
     if(!objects.back().isEmpty())
@@ -390,19 +404,39 @@ void VisualObjects::startMMAnim(size_t i, std::string_view animName, float inten
   if(id==size_t(-1))
     return;
 
-  objectsMorph.insert(i);
-
   auto& m = anim[id];
   if(timeUntil==uint64_t(-1) && m.duration>0)
     timeUntil = scene.tickCount + m.duration;
 
+  if(!implStartMMAnim(obj, id, intensity, timeUntil)) {
+    size_t nId = 0;
+    for(size_t i=0; i<Resources::MAX_MORPH_LAYERS; ++i) {
+      if(obj.morphAnim[nId].timeStart<=obj.morphAnim[i].timeStart)
+        continue;
+      nId = i;
+      }
+
+    auto& ani = obj.morphAnim[nId];
+    ani.id        = id;
+    ani.timeStart = scene.tickCount;
+    ani.timeUntil = timeUntil;
+    ani.intensity = intensity;
+    }
+
+  updateMorph(i);
+  }
+
+bool VisualObjects::implStartMMAnim(Object& obj, size_t id, float intensity, uint64_t timeUntil) {
+  auto& anim = *obj.bucketId->staticMesh->morph.anim;
+  auto& m    = anim[id];
+
   // extend time of anim
   for(auto& i:obj.morphAnim) {
     if(i.id!=id || i.timeUntil<scene.tickCount)
       continue;
     i.timeUntil = timeUntil;
     i.intensity = intensity;
-    return;
+    return true;
     }
 
   // find same layer
@@ -414,21 +448,33 @@ void VisualObjects::startMMAnim(size_t i, std::string_view animName, float inten
     i.id        = id;
     i.timeUntil = timeUntil;
     i.intensity = intensity;
-    return;
+    return true;
     }
 
-  size_t nId = 0;
-  for(size_t i=0; i<Resources::MAX_MORPH_LAYERS; ++i) {
-    if(obj.morphAnim[nId].timeStart<=obj.morphAnim[i].timeStart)
+  return false;
+  }
+
+void VisualObjects::updateMorph(size_t i) {
+  auto& obj  = objects[i];
+  auto& anim = *obj.bucketId->staticMesh->morph.anim;
+
+  MorphData data = {};
+  for(size_t r=0; r<Resources::MAX_MORPH_LAYERS; ++r) {
+    auto& ani = obj.morphAnim[r];
+    auto& d   = data.morph[r];
+    if(ani.timeUntil<scene.tickCount || ani.id>=anim.size())
       continue;
-    nId = i;
-    }
 
-  auto& ani = obj.morphAnim[nId];
-  ani.id        = id;
-  ani.timeStart = scene.tickCount;
-  ani.timeUntil = timeUntil;
-  ani.intensity = intensity;
+    auto& m = anim[ani.id];
+    d.indexOffset     = uint32_t(m.index);
+    d.samplesPerFrame = uint32_t(m.samplesPerFrame);
+    d.tickPerFrame    = uint32_t(std::max<uint64_t>(m.tickPerFrame, 1));
+    d.numFrames       = uint32_t(std::max<size_t>(m.numFrames, 1));
+    d.timeStart       = uint32_t(ani.timeStart);
+    d.timeUntil       = ani.timeUntil==uint64_t(-1) ? uint32_t(-1) : uint32_t(ani.timeUntil);
+    d.intensity       = ani.intensity;
+    }
+  obj.objMorphAnim.set(&data, 0, sizeof(data));
   }
 
 void VisualObjects::setAsGhost(size_t id, bool g) {
@@ -468,92 +514,6 @@ void VisualObjects::prepareGlobals(Encoder<CommandBuffer>& enc, uint8_t fId) {
   bucketsMem.commit(enc, fId);
   }
 
-void VisualObjects::preFrameUpdate() {
-  preFrameUpdateWind();
-  preFrameUpdateMorph();
-  }
-
-void VisualObjects::preFrameUpdateWind() {
-  if(!scene.zWindEnabled)
-    return;
-
-  const uint64_t period = scene.windPeriod;
-  float ax = float(scene.tickCount%period)/float(period);
-  ax = ax*2.f-1.f;
-
-  for(auto id:objectsWind) {
-    auto& i = objects[id];
-    float m = 0;
-
-    switch(i.wind) {
-      case zenkit::AnimationType::WIND:
-        // tree. note: mods tent to bump Intensity to insane values
-        if(i.windIntensity>0.f)
-          m = 0.03f; else
-          m = 0;
-        break;
-      case zenkit::AnimationType::WIND_ALT:
-        // grass
-        if(i.windIntensity>0.f && i.windIntensity<=1.0)
-          m = i.windIntensity * 0.1f; else
-          m = 0;
-        break;
-      case zenkit::AnimationType::NONE:
-      default:
-        // error
-        m = 0.f;
-        break;
-      }
-
-    auto  pos   = i.pos;
-    float shift = i.pos[3][0]*scene.windDir.x + i.pos[3][2]*scene.windDir.y;
-    const float a = m * std::cos(float(ax*M_PI) + shift*0.0001f);
-
-    pos[1][0] += scene.windDir.x*a;
-    pos[1][2] += scene.windDir.y*a;
-
-    updateInstance(id, &pos);
-    }
-  }
-
-void VisualObjects::preFrameUpdateMorph() {
-  for(auto it=objectsMorph.begin(); it!=objectsMorph.end(); ) {
-    auto& obj = objects[*it];
-
-    bool reschedule = false;
-    MorphData data = {};
-    for(size_t i=0; i<Resources::MAX_MORPH_LAYERS; ++i) {
-      auto&    ani  = obj.morphAnim[i];
-      auto&    bk   = *obj.bucketId;
-      auto&    anim = (*bk.staticMesh->morph.anim)[ani.id];
-      uint64_t time = (scene.tickCount-ani.timeStart);
-
-      float    alpha     = float(time%anim.tickPerFrame)/float(anim.tickPerFrame);
-      float    intensity = ani.intensity;
-
-      if(scene.tickCount>ani.timeUntil) {
-        data.morph[i].intensity = 0;
-        continue;
-        }
-
-      if(anim.numFrames>1)
-        reschedule = true;
-
-      const uint32_t samplesPerFrame = uint32_t(anim.samplesPerFrame);
-      data.morph[i].indexOffset = uint32_t(anim.index);
-      data.morph[i].sample0     = uint32_t((time/anim.tickPerFrame+0)%anim.numFrames)*samplesPerFrame;
-      data.morph[i].sample1     = uint32_t((time/anim.tickPerFrame+1)%anim.numFrames)*samplesPerFrame;
-      data.morph[i].alpha       = uint16_t(alpha*uint16_t(-1));
-      data.morph[i].intensity   = uint16_t(intensity*uint16_t(-1));
-      }
-
-    obj.objMorphAnim.set(&data, 0, sizeof(data));
-    if(!reschedule)
-      it = objectsMorph.erase(it); else
-      it++;
-    }
-  }
-
 void VisualObjects::visibilityPass(Tempest::Encoder<Tempest::CommandBuffer> &cmd, int pass) {
   drawCmd.visibilityPass(cmd, pass);
   }
@@ -607,7 +567,7 @@ void VisualObjects::postFrameupdate() {
 
 bool VisualObjects::updateRtScene(RtScene& out) {
   if(!out.isUpdateRequired())
-    return false;
+    return out.updateTextures();
   for(auto& obj:objects) {
     if(obj.isEmpty())
       continue;
@@ -64,6 +64,7 @@ class VisualObjects final {
     InstanceStorage::Id alloc(size_t size);
     bool                realloc(InstanceStorage::Id& id, size_t size);
     auto                instanceSsbo() const -> const Tempest::StorageBuffer&;
+    auto                instanceStats() const -> const InstanceStorage::Stats& { return instanceMem.stats(); }
 
     const DrawClusters& clusters()     const { return clustersMem; }
     const DrawCommands& drawCommands() const { return drawCmd; }
@@ -71,7 +72,6 @@ class VisualObjects final {
 
     void resetRendering();
 
-    void preFrameUpdate ();
     void prepareGlobals (Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId);
     void postFrameupdate();
 
@@ -125,9 +125,6 @@ class VisualObjects final {
       bool                isGhost       = false;
       };
 
-    void     preFrameUpdateWind();
-    void     preFrameUpdateMorph();
-
     size_t   implAlloc();
     void     free(size_t id);
 
@@ -135,10 +132,13 @@ class VisualObjects final {
     uint32_t clusterId(const DrawBuckets::Bucket& bucket, size_t firstMeshlet, size_t meshletCount, uint16_t bucketId, uint16_t commandId);
 
     void     startMMAnim(size_t i, std::string_view animName, float intensity, uint64_t timeUntil);
+    bool     implStartMMAnim(Object& obj, size_t id, float intensity, uint64_t timeUntil);
+    void     updateMorph(size_t i);
     void     setAsGhost(size_t i, bool g);
 
     void     notifyTlas(const Material& m, RtScene::Category cat);
-    void     updateInstance(size_t id, Tempest::Matrix4x4* pos = nullptr);
+    void     updateInstance(size_t id);
+    static float windAmplitude(const Object& obj);
     void     updateRtAs(size_t id);
 
     void     dbgDraw(Tempest::Painter& p, Tempest::Vec2 wsz, const Camera& cam, const DrawClusters::Cluster& cx);
@@ -152,8 +152,6 @@ class VisualObjects final {
     DrawCommands               drawCmd;
 
     std::vector<Object>        objects;
-    std::unordered_set<size_t> objectsWind;
-    std::unordered_set<size_t> objectsMorph;
     std::unordered_set<size_t> objectsFree;
 
     friend class Item;
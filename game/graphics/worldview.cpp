@@ -4,6 +4,7 @@
 
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "world/world.h"
+#include "utils/profiler.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -45,6 +46,7 @@ void WorldView::resetRendering() {
   }
 
 void WorldView::preFrameUpdate(const Camera& camera, uint64_t tickCount, uint8_t fId) {
+  PROFILE_SCOPE("WorldView::preFrameUpdate");
   const auto ldir = gSky.sunLight().dir();
   Tempest::Matrix4x4 shadow   [Resources::ShadowLayers];
   Tempest::Matrix4x4 shadowLwc[Resources::ShadowLayers];
@@ -67,7 +69,6 @@ void WorldView::preFrameUpdate(const Camera& camera, uint64_t tickCount, uint8_t
   sGlobal.commitUbo(fId);
 
   pfxGroup.preFrameUpdate(fId);
-  visuals .preFrameUpdate();
   }
 
 void WorldView::prepareGlobals(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId) {
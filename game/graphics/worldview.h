@@ -83,10 +83,13 @@ class WorldView {
     const Sky&          sky() const { return gSky; }
     const Landscape&    landscape() const { return land; }
     const LightGroup&   lights() const { return gLights; }
+    const PfxObjects&   particles() const { return pfxGroup; }
+    PfxObjects&         particles()       { return pfxGroup; }
     const DrawClusters& clusters() const;
     const DrawCommands& drawCommands() const;
     const DrawBuckets&  drawBuckets() const;
     auto                instanceSsbo() const -> const Tempest::StorageBuffer&;
+    auto                instanceStats() const -> const InstanceStorage::Stats& { return visuals.instanceStats(); }
 
   private:
     const World&  owner;
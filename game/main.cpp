@@ -20,6 +20,7 @@
 
 #include "utils/crashlog.h"
 #include "mainwindow.h"
+#include "simbenchmark.h"
 #include "gothic.h"
 #include "build.h"
 #include "commandline.h"
@@ -128,6 +129,17 @@ int main(int argc,const char** argv) {
   Workers::setThreadName("Main thread");
 
   CommandLine          cmd{argc,argv};
+  if(cmd.simBenchmarkHours()>0) {
+    // simulation only: no graphics api, device or window
+    Resources    resources;
+    Gothic       gothic;
+    GameMusic    music;
+    gothic.setupGlobalScripts();
+
+    SimBenchmark bench(cmd);
+    return bench.exec();
+    }
+
   auto                 api     = mkApi(cmd);
   const auto           gpuName = selectDevice(*api);
   CrashLog::setGpu(gpuName);
@@ -22,6 +22,7 @@
 #include "game/globaleffects.h"
 #include "utils/gthfont.h"
 #include "utils/dbgpainter.h"
+#include "utils/profiler.h"
 
 #include "commandline.h"
 #include "gothic.h"
@@ -271,6 +272,28 @@ void MainWindow::paintEvent(PaintEvent& event) {
 
     auto& fnt = Resources::font(scale);
     fnt.drawText(p,5,fnt.pixelSize()+5,fpsT);
+
+    int line = 1;
+    auto tex = Resources::textureStats();
+    if(tex.loaded>0 || tex.pending>0) {
+      const size_t staged = size_t(tex.staged/std::max<uint64_t>(tex.decoded,1));
+      string_frm texT("textures: pending = ",tex.pending," latency = ",tex.latency,"/",tex.latencyMax," ms staged = ",staged," bytes/texture");
+      fnt.drawText(p,5,++line*(fnt.pixelSize()+5),texT);
+      }
+
+    if(auto wx = Gothic::inst().worldView()) {
+      auto pfx = wx->particles().stats();
+      string_frm pfxT("particles = ",pfx.particles," emitters = ",pfx.emitters," sleeping = ",pfx.sleeping);
+      fnt.drawText(p,5,++line*(fnt.pixelSize()+5),pfxT);
+
+      auto& inst = wx->instanceStats();
+      string_frm instT("instance upload = ",inst.uploadBytes/1024," KB patches = ",inst.patches,(inst.deferred ? " (deferred)" : ""));
+      fnt.drawText(p,5,++line*(fnt.pixelSize()+5),instT);
+
+      auto& lt = wx->lights().stats();
+      string_frm lightT("lights: animated = ",lt.animated," groups = ",lt.groups," updates = ",lt.updates," patch = ",lt.patchBytes," bytes");
+      fnt.drawText(p,5,++line*(fnt.pixelSize()+5),lightT);
+      }
     }
 
   if(Gothic::inst().doClock() && world!=nullptr) {
@@ -283,6 +306,16 @@ void MainWindow::paintEvent(PaintEvent& event) {
       }
     }
 
+  if(Profiler::isEnabled() && !Gothic::inst().isDesktop()) {
+    auto& fnt   = Resources::font(scale);
+    auto  stats = Profiler::frameStats();
+    int   line  = 1;
+    for(size_t i=0; i<stats.size() && i<16; ++i) {
+      string_frm profT(stats[i].name," = ",size_t(stats[i].timeUs)," us (",stats[i].calls,")");
+      fnt.drawText(p,w()-fnt.textSize(profT).w-5,++line*(fnt.pixelSize()+5),profT);
+      }
+    }
+
   if(auto wx = Gothic::inst().worldView()) {
     wx->dbgClusters(p, Vec2(float(w()), float(h())));
     }
@@ -1190,6 +1223,7 @@ void MainWindow::render(){
       return;
       }
     Resources::resetRecycled(cmdId);
+    Resources::commitTextures();
 
     if(video.isActive()) {
       video.paint(device,cmdId);
@@ -1228,6 +1262,7 @@ void MainWindow::render(){
       t += delay;
       }
     fps.push(t-time);
+    Profiler::frame();
     if(Gothic::inst().isBenchmarkMode() && Gothic::inst().world()!=nullptr && Gothic::inst().world()->currentCs()!=nullptr)
       benchmark.push(t-time);
     time = t;
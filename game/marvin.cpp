@@ -1,13 +1,16 @@
 #include "marvin.h"
 
 #include <charconv>
+#include <chrono>
 #include <cstdint>
 #include <cctype>
 
 #include "utils/string_frm.h"
+#include "utils/profiler.h"
 #include "world/objects/npc.h"
 #include "world/objects/item.h"
 #include "world/triggers/abstracttrigger.h"
+#include "graphics/worldview.h"
 #include "camera.h"
 #include "gothic.h"
 
@@ -148,6 +151,12 @@ Marvin::Marvin() {
     {"toggle gi",                  C_ToggleGI},
     {"toggle vsm",                 C_ToggleVsm},
     {"toggle rtsm",                C_ToggleRtsm},
+    {"toggle profiler",            C_ToggleProfiler},
+    {"profiler dump",              C_ProfilerDump},
+    {"dialog benchmark",           C_DialogBench},
+    {"pfx benchmark",              C_PfxBench},
+    {"toggle script profiler",     C_ToggleScriptProfiler},
+    {"script profiler dump",       C_ScriptProfilerDump},
     };
   }
 
@@ -456,6 +465,46 @@ bool Marvin::exec(std::string_view v) {
     case C_ToggleRtsm:
       Gothic::inst().toggleRtsm();
       return true;
+    case C_ToggleProfiler:
+      if(!Profiler::isAvailable()) {
+        print("profiler is not available in this build");
+        return true;
+        }
+      Profiler::setEnabled(!Profiler::isEnabled());
+      return true;
+    case C_ProfilerDump:
+      if(!Profiler::dumpTrace("trace.json"))
+        return false;
+      print("profiler trace saved to trace.json");
+      return true;
+    case C_DialogBench: {
+      World* world  = Gothic::inst().world();
+      Npc*   player = Gothic::inst().player();
+      if(world==nullptr || player==nullptr)
+        return false;
+      return dialogBenchmark(*world, *player);
+      }
+    case C_PfxBench: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr || world->view()==nullptr)
+        return false;
+      return pfxBenchmark(*world);
+      }
+    case C_ToggleScriptProfiler: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      auto& prof = world->script().scriptProfiler();
+      prof.setEnabled(!prof.isEnabled());
+      print(prof.isEnabled() ? "script profiler: on" : "script profiler: off");
+      return true;
+      }
+    case C_ScriptProfilerDump: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      return scriptProfilerDump(*world);
+      }
     }
 
   return true;
@@ -589,6 +638,54 @@ bool Marvin::goToVob(World& world, Npc& player, Camera& c, std::string_view name
   return true;
   }
 
+bool Marvin::dialogBenchmark(World& world, Npc& player) {
+  // NOTE: evaluates dialog conditions for every npc in the world, same as opening dialog menu with each of them
+  const std::vector<uint32_t> except;
+  size_t     npcs    = 0;
+  size_t     choices = 0;
+  const auto begin   = std::chrono::steady_clock::now();
+  for(uint32_t i=0; i<world.npcCount(); ++i) {
+    auto npc = world.npcById(i);
+    if(npc==nullptr || npc==&player)
+      continue;
+    choices += npc->dialogChoices(player,except,true).size();
+    ++npcs;
+    }
+  const auto end = std::chrono::steady_clock::now();
+
+  const double ms = std::chrono::duration<double,std::milli>(end-begin).count();
+  string_frm msg("dialogs: npc = ", npcs, " choices = ", choices, " time = ", ms, " ms");
+  print(msg);
+  return true;
+  }
+
+bool Marvin::pfxBenchmark(World& world) {
+  // NOTE: particles in view are fast-forwarded by iterations*dt for each thread count
+  auto& pfx = world.view()->particles();
+  for(auto& s:pfx.benchmarkScaling(16,60)) {
+    string_frm msg("pfx: threads = ", s.threads, " tick = ", s.tickMs, " ms particles/ms = ", s.particlesPerMs);
+    print(msg);
+    }
+  return true;
+  }
+
+bool Marvin::scriptProfilerDump(World& world) {
+  auto& prof = world.script().scriptProfiler();
+  if(!prof.dumpFolded("scriptprofile.folded"))
+    return false;
+
+  auto stats = prof.hotFunctions();
+  for(size_t i=0; i<stats.size() && i<10; ++i) {
+    auto&      s = stats[i];
+    string_frm msg(s.name, s.external ? " [ext]" : "", ": calls = ", size_t(s.calls),
+                   " self = ", double(s.exclusiveNs)/1000000.0, " ms",
+                   " total = ", double(s.inclusiveNs)/1000000.0, " ms");
+    print(msg);
+    }
+  print("script profile saved to scriptprofile.folded");
+  return true;
+  }
+
 std::string_view Marvin::completeInstanceName(std::string_view inp, bool& fullword) const {
   World* world  = Gothic::inst().world();
   if(world==nullptr || inp.size()==0)
@@ -62,6 +62,12 @@ class Marvin {
       C_ToggleGI,
       C_ToggleVsm,
       C_ToggleRtsm,
+      C_ToggleProfiler,
+      C_ProfilerDump,
+      C_DialogBench,
+      C_PfxBench,
+      C_ToggleScriptProfiler,
+      C_ScriptProfilerDump,
       };
 
     struct Cmd {
@@ -90,6 +96,9 @@ class Marvin {
     bool   setVariable             (World* world, std::string_view name, std::string_view value);
     bool   setTime                 (World& world, std::string_view hh, std::string_view mm);
     bool   goToVob                 (World& world, Npc& player, Camera& c, std::string_view name, size_t n);
+    bool   dialogBenchmark         (World& world, Npc& player);
+    bool   pfxBenchmark            (World& world);
+    bool   scriptProfilerDump      (World& world);
 
     std::vector<Cmd> cmd;
   };
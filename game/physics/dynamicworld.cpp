@@ -13,6 +13,7 @@
 #include "world/objects/item.h"
 #include "world/bullet.h"
 #include "world/world.h"
+#include "utils/profiler.h"
 
 const float DynamicWorld::ghostPadding=50-22.5f;
 const float DynamicWorld::ghostHeight =140;
@@ -823,6 +824,7 @@ void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t
   }
 
 void DynamicWorld::tick(uint64_t dt) {
+  PROFILE_SCOPE("DynamicWorld::tick");
   npcList   ->tickAabbs();
   bulletList->tick(dt);
   world     ->tick(dt);
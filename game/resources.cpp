@@ -1,6 +1,7 @@
 #include "resources.h"
 
 #include <Tempest/MemReader>
+#include <Tempest/IDevice>
 #include <Tempest/Pixmap>
 #include <Tempest/Device>
 #include <Tempest/Dir>
@@ -11,6 +12,10 @@
 #include <Tempest/Log>
 #include <Tempest/Color>
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
 #include <zenkit/MultiResolutionMesh.hh>
 #include <zenkit/ModelHierarchy.hh>
 #include <zenkit/Model.hh>
@@ -30,6 +35,8 @@
 #include "dmusic/directmusic.h"
 #include "utils/fileext.h"
 #include "utils/gthfont.h"
+#include "utils/workers.h"
+#include "utils/profiler.h"
 
 #include "gothic.h"
 #include "utils/string_frm.h"
@@ -40,6 +47,83 @@ using namespace Tempest;
 
 Resources* Resources::inst=nullptr;
 
+// decoded pcm bytes
+const size_t Resources::sndCacheBudget = 64*1024*1024;
+
+// Tempest decoders on top of vdfs entry: decoder reads straight from archive, without copy of whole file
+struct VdfsDevice : Tempest::IDevice {
+  VdfsDevice(zenkit::Read& fin):fin(fin) {
+    fin.seek(0, zenkit::Whence::END);
+    sz = fin.tell();
+    fin.seek(0, zenkit::Whence::BEG);
+    }
+
+  size_t read(void* to, size_t count) override {
+    return fin.read(to,count);
+    }
+  size_t size() const override {
+    return sz;
+    }
+  uint8_t peek() override {
+    uint8_t ret = 0;
+    if(fin.read(&ret,1)==1)
+      fin.seek(-1, zenkit::Whence::CUR);
+    return ret;
+    }
+  size_t seek(size_t advance) override {
+    const size_t mv = std::min(advance, sz-fin.tell());
+    fin.seek(ptrdiff_t(mv), zenkit::Whence::CUR);
+    return mv;
+    }
+  size_t unget(size_t advance) override {
+    const size_t mv = std::min(advance, fin.tell());
+    fin.seek(-ptrdiff_t(mv), zenkit::Whence::CUR);
+    return mv;
+    }
+
+  zenkit::Read& fin;
+  size_t        sz = 0;
+  };
+
+// size of decoded 16-bit pcm, estimated from riff-header; compressed wav's decode to several times of file size
+static size_t pcmSize(const std::vector<uint8_t>& wav) {
+  auto u16 = [&](size_t at) { return uint32_t(wav[at]) | uint32_t(wav[at+1])<<8; };
+  auto u32 = [&](size_t at) { return u16(at) | u16(at+2)<<16; };
+
+  if(wav.size()<12 || std::memcmp(wav.data(),"RIFF",4)!=0 || std::memcmp(wav.data()+8,"WAVE",4)!=0)
+    return wav.size();
+
+  uint32_t format = 0, channels = 0, blockAlign = 0, bits = 0, samplesPerBlock = 0, data = 0;
+  for(size_t at=12; at+8<=wav.size();) {
+    const uint32_t len = u32(at+4);
+    if(std::memcmp(wav.data()+at,"fmt ",4)==0 && at+24<=wav.size()) {
+      format     = u16(at+8);
+      channels   = u16(at+10);
+      blockAlign = u16(at+20);
+      bits       = u16(at+22);
+      if(len>=20 && at+28<=wav.size())
+        samplesPerBlock = u16(at+26);
+      }
+    else if(std::memcmp(wav.data()+at,"data",4)==0) {
+      data = len;
+      }
+    at += 8 + len + (len&1);
+    }
+
+  if(channels==0 || blockAlign==0)
+    return wav.size();
+  switch(format) {
+    case 1: // pcm
+      return size_t(data/blockAlign)*channels*2;
+    case 2:    // ms-adpcm
+    case 0x11: // ima-adpcm
+      if(samplesPerBlock>0)
+        return size_t(data/blockAlign)*samplesPerBlock*channels*2;
+      break;
+    }
+  return std::max<size_t>(wav.size(), size_t(data)*(bits>0 ? 16/std::min<uint32_t>(bits,16) : 4));
+  }
+
 static void emplaceTag(char* buf, char tag){
   for(size_t i=1;buf[i];++i){
     if(buf[i]==tag && buf[i-1]=='_' && buf[i+1]=='0'){
@@ -51,20 +135,9 @@ static void emplaceTag(char* buf, char tag){
     }
   }
 
-Resources::Resources(Tempest::Device &device)
-  : dev(device) {
+Resources::Resources() {
   inst=this;
 
-  static const uint16_t index[] = {
-      0, 1, 2, 0, 2, 3,
-      4, 6, 5, 4, 7, 6,
-      1, 5, 2, 2, 5, 6,
-      4, 0, 7, 7, 0, 3,
-      3, 2, 7, 7, 2, 6,
-      4, 5, 0, 0, 5, 1
-    };
-  cube = device.ibo(index, sizeof(index)/sizeof(index[0]));
-
   dxMusic.reset(new Dx8::DirectMusic());
   // G2
   dxMusic->addPath(Gothic::nestedPath({u"_work",u"Data",u"Music",u"newworld"},  Dir::FT_Dir));
@@ -76,24 +149,6 @@ Resources::Resources(Tempest::Device &device)
   // switch-build
   dxMusic->addPath(Gothic::nestedPath({u"_work",u"Data",u"Music"},Dir::FT_Dir));
 
-  fBuff .reserve(8*1024*1024);
-  ddsBuf.reserve(8*1024*1024);
-
-  {
-  Pixmap pm(1,1,TextureFormat::RGBA8);
-  uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
-  pix[0]=255;
-  pix[3]=255;
-  fallback = device.texture(pm);
-  }
-
-  {
-  Pixmap pm(1,1,TextureFormat::RGBA8);
-  fbZero = device.texture(pm);
-  }
-
-  fbImg = device.image2d(TextureFormat::R32U,1,1);
-
   // Set up the DirectMusic loader
   DmResult rv = DmLoader_create(&dmLoader, DmLoader_DOWNLOAD);
   if(rv != DmResult_SUCCESS) {
@@ -121,6 +176,40 @@ Resources::Resources(Tempest::Device &device)
   }, this);
   }
 
+Resources::Resources(Tempest::Device &device)
+  : Resources() {
+  dev = &device;
+
+  static const uint16_t index[] = {
+      0, 1, 2, 0, 2, 3,
+      4, 6, 5, 4, 7, 6,
+      1, 5, 2, 2, 5, 6,
+      4, 0, 7, 7, 0, 3,
+      3, 2, 7, 7, 2, 6,
+      4, 5, 0, 0, 5, 1
+    };
+  cube = device.ibo(index, sizeof(index)/sizeof(index[0]));
+
+  {
+  Pixmap pm(1,1,TextureFormat::RGBA8);
+  uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
+  pix[0]=255;
+  pix[3]=255;
+  fallback = device.texture(pm);
+  }
+
+  {
+  Pixmap pm(1,1,TextureFormat::RGBA8);
+  fbZero = device.texture(pm);
+  }
+
+  fbImg = device.image2d(TextureFormat::R32U,1,1);
+
+  texLoader = std::thread([this]() noexcept {
+    asyncTextureLoop();
+    });
+  }
+
 void Resources::mountWork(const std::filesystem::path& path) {
   inst->gothicAssets.mkdir("/_work");
   inst->gothicAssets.mount_host(path, "/_work", zenkit::VfsOverwriteBehavior::NONE);
@@ -180,6 +269,14 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
   }
 
 Resources::~Resources() {
+  {
+  std::lock_guard<std::mutex> g(texSync);
+  texLoaderExit = true;
+  }
+  texCnd.notify_one();
+  if(texLoader.joinable())
+    texLoader.join();
+
   DmLoader_release(dmLoader);
   inst=nullptr;
   }
@@ -235,7 +332,9 @@ std::unique_ptr<zenkit::ReadArchive> Resources::openReader(std::string_view name
   }
 
 const char* Resources::renderer() {
-  return inst->dev.properties().name;
+  if(isHeadless())
+    return "headless";
+  return inst->dev->properties().name;
   }
 
 static Sampler implShadowSampler() {
@@ -339,7 +438,7 @@ int64_t Resources::vdfTimestamp(const std::u16string& name) {
   }
 
 Tempest::Texture2d* Resources::implLoadTexture(std::string_view cname, bool forceMips) {
-  if(cname.empty())
+  if(cname.empty() || dev==nullptr)
     return nullptr;
 
   //TODO: __cpp_lib_generic_unordered_lookup
@@ -359,9 +458,135 @@ Tempest::Texture2d* Resources::implLoadTexture(std::string_view cname, bool forc
   return nullptr;
   }
 
+Tempest::Texture2d* Resources::implLoadTextureAsync(std::string_view cname) {
+  if(cname.empty() || dev==nullptr)
+    return nullptr;
+
+  std::string name = std::string(cname);
+  auto it=texCache.find(name);
+  if(it!=texCache.end())
+    return it->second.get();
+
+  TextureFormat frm = TextureFormat::RGBA8;
+  if(!implTextureHint(name,frm)) {
+    texCache[std::move(name)] = nullptr;
+    return nullptr;
+    }
+
+  // placeholder, until actual texture is decoded by texLoader; see commitTextures
+  Pixmap pm(1,1,TextureFormat::RGBA8);
+  uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
+  pix[0]=255;
+  pix[3]=255;
+
+  std::unique_ptr<Texture2d> t{new Texture2d(dev->texture(pm))};
+  Texture2d* ret=t.get();
+  texCache[name] = std::move(t);
+
+  AsyncTexture rq;
+  rq.name      = std::move(name);
+  rq.dst       = ret;
+  rq.timeStart = Application::tickCount();
+  {
+  std::lock_guard<std::mutex> g(texSync);
+  texPendingFormat[ret] = frm;
+  // distance is not known yet: queued behind positioned requests, until prioritizeTexture
+  texQueue.push({rq.qDist, texRequestSeq++, ret});
+  texRequests[ret] = std::move(rq);
+  texRequestsCount.store(texRequests.size());
+  texStats.pending++;
+  }
+  texCnd.notify_one();
+  return ret;
+  }
+
+bool Resources::implTextureHint(std::string_view name, Tempest::TextureFormat& frm) {
+  frm = TextureFormat::RGBA8;
+  if(FileExt::hasExt(name,"TGA")) {
+    auto nameAlt = std::string(name);
+    nameAlt.resize(nameAlt.size() + 2);
+    std::memcpy(&nameAlt[0]+nameAlt.size()-6, "-C.TEX", 6);
+
+    if(const auto* entry = Resources::vdfsIndex().find(nameAlt)) {
+      // ZTEX header: magic, version, format
+      uint32_t hdr[3] = {};
+      auto reader = entry->open_read();
+      reader->read(hdr, sizeof(hdr));
+      switch(zenkit::TextureFormat(hdr[2])) {
+        case zenkit::TextureFormat::DXT1:
+          frm = TextureFormat::DXT1;
+          break;
+        case zenkit::TextureFormat::DXT3:
+          frm = TextureFormat::DXT3;
+          break;
+        case zenkit::TextureFormat::DXT5:
+          frm = TextureFormat::DXT5;
+          break;
+        default:
+          break;
+        }
+      return true;
+      }
+    }
+  return Resources::vdfsIndex().find(name)!=nullptr;
+  }
+
+void Resources::asyncTextureLoop() {
+  Workers::setThreadName("Resources: texture loader");
+
+  while(true) {
+    AsyncTexture rq;
+    {
+    std::unique_lock<std::mutex> lck(texSync);
+    texCnd.wait(lck,[this](){ return texLoaderExit || !texQueue.empty(); });
+    if(texLoaderExit)
+      return;
+    const auto top = texQueue.top();
+    texQueue.pop();
+    auto it = texRequests.find(top.dst);
+    if(it==texRequests.end())
+      continue; // stale entry: request was taken by nearer one
+    rq = std::move(it->second);
+    texRequests.erase(it);
+    texRequestsCount.store(texRequests.size());
+    }
+
+    // NOTE: no global lock - decoding is cpu-only; upload happens in commitTextures
+    try {
+      rq.decoded = implLoadPixmap(rq.name, false, rq.pm, rq.mips);
+      if(!rq.decoded) {
+        // same fallback, as synchronous path in Material
+        Log::e("unable to load texture \"",rq.name,"\"");
+        rq.decoded = implLoadPixmap("DEFAULT.TGA", false, rq.pm, rq.mips);
+        }
+      }
+    catch(...) {
+      Log::e("unable to load texture \"",rq.name,"\"");
+      rq.decoded = false;
+      }
+
+    std::lock_guard<std::mutex> lck(texSync);
+    texReady.emplace_back(std::move(rq));
+    }
+  }
+
 Texture2d Resources::implLoadTextureUncached(std::string_view name, bool forceMips) {
-  if(name.empty())
+  Pixmap pm;
+  bool   mips = false;
+  if(dev==nullptr || !implLoadPixmap(name, forceMips, pm, mips))
+    return Texture2d();
+  try {
+    return dev->texture(pm, mips);
+    }
+  catch(...) {
     return Texture2d();
+    }
+  }
+
+bool Resources::implLoadPixmap(std::string_view name, bool forceMips, Tempest::Pixmap& pm, bool& mips) {
+  PROFILE_SCOPE("load: texture");
+  if(name.empty())
+    return false;
 
   if(FileExt::hasExt(name,"TGA")) {
     auto nameAlt = std::string(name);
@@ -379,17 +604,27 @@ Texture2d Resources::implLoadTextureUncached(std::string_view name, bool forceMi
          tex.format() == zenkit::TextureFormat::DXT3 ||
          tex.format() == zenkit::TextureFormat::DXT4 ||
          tex.format() == zenkit::TextureFormat::DXT5) {
+        // NOTE: parse dds in-place, instead of copying it to yet another buffer
         auto dds = zenkit::to_dds(tex);
-        auto ddsRead = zenkit::Read::from(dds);
-
-        return implLoadTextureUncached(name, *ddsRead, forceMips);
+        texStaged.fetch_add(dds.size());
+        try {
+          Tempest::MemReader rd(reinterpret_cast<uint8_t*>(dds.data()), dds.size());
+          implDecodeTexture(rd, forceMips, pm, mips);
+          return true;
+          }
+        catch(...) {
+          return false;
+          }
         } else {
         auto rgba = tex.as_rgba8(0);
+        texStaged.fetch_add(rgba.size());
 
         try {
-          Tempest::Pixmap    pm(tex.width(), tex.height(), TextureFormat::RGBA8);
+          pm = Tempest::Pixmap(tex.width(), tex.height(), TextureFormat::RGBA8);
           std::memcpy(pm.data(), rgba.data(), rgba.size());
-          return dev.texture(pm);
+          mips = true; // Device::texture default
+          texDecoded.fetch_add(1);
+          return true;
           }
         catch (...) {
           }
@@ -399,30 +634,28 @@ Texture2d Resources::implLoadTextureUncached(std::string_view name, bool forceMi
 
   if(auto* entry = Resources::vdfsIndex().find(name)) {
     auto reader = entry->open_read();
-    return implLoadTextureUncached(name, *reader, forceMips);
+    return implLoadPixmap(*reader, forceMips, pm, mips);
     }
-  return Texture2d();
+  return false;
   }
 
-Texture2d Resources::implLoadTextureUncached(std::string_view name, zenkit::Read& data, bool forceMips) {
+bool Resources::implLoadPixmap(zenkit::Read& data, bool forceMips, Tempest::Pixmap& pm, bool& mips) {
   try {
-    std::vector<uint8_t> raw;
-    data.seek(0, zenkit::Whence::END);
-    raw.resize(data.tell());
-    data.seek(0, zenkit::Whence::BEG);
-    data.read(raw.data(), raw.size());
-
-    Tempest::MemReader rd((uint8_t*)raw.data(), raw.size());
-    Tempest::Pixmap    pm(rd);
-
-    const bool useMipmap = forceMips || (pm.mipCount()>1); // do not generate mips, if original texture has has none
-    return dev.texture(pm, useMipmap);
+    VdfsDevice rd(data);
+    implDecodeTexture(rd, forceMips, pm, mips);
+    return true;
     }
   catch(...){
-    return Texture2d();
+    return false;
     }
   }
 
+void Resources::implDecodeTexture(Tempest::IDevice& rd, bool forceMips, Tempest::Pixmap& pm, bool& mips) {
+  pm   = Tempest::Pixmap(rd);
+  mips = forceMips || (pm.mipCount()>1); // do not generate mips, if original texture has has none
+  texDecoded.fetch_add(1);
+  }
+
 ProtoMesh* Resources::implLoadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
@@ -441,6 +674,7 @@ ProtoMesh* Resources::implLoadMesh(std::string_view name) {
   }
 
 std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
+  PROFILE_SCOPE("load: mesh");
   if(FileExt::hasExt(name,"3DS")) {
     FileExt::exchangeExt(name,"3DS","MRM");
 
@@ -660,6 +894,7 @@ ProtoMesh* Resources::implDecalMesh(const zenkit::VisualDecal& decal) {
   }
 
 std::unique_ptr<Animation> Resources::implLoadAnimation(std::string name) {
+  PROFILE_SCOPE("load: animation");
   if(name.size()<4)
     return nullptr;
 
@@ -695,14 +930,15 @@ DmSegment* Resources::implLoadMusicSegment(char const* name) {
   return sgt;
   }
 
-Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
-  if(name.empty())
-    return Tempest::Sound();
-
-  if(!getFileData(name,fBuff))
+Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name, size_t& size) {
+  PROFILE_SCOPE("load: sound");
+  // NOTE: no lock here - decoding is slow and vdfs-index is immutable at this point
+  std::vector<uint8_t> data;
+  if(!getFileData(name,data))
     return Tempest::Sound();
   try {
-    Tempest::MemReader rd(fBuff.data(),fBuff.size());
+    Tempest::MemReader rd(data.data(),data.size());
+    size = pcmSize(data);
     return Tempest::Sound(rd);
     }
   catch(...) {
@@ -712,6 +948,31 @@ Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
     }
   }
 
+void Resources::implCacheSound(const std::string& name, const Tempest::Sound& snd, size_t size) {
+  if(size>sndCacheBudget/16)
+    return; // long dialogs are not reused often enough, to keep them in memory
+
+  auto ins = sndCache.try_emplace(name);
+  auto& c   = ins.first->second;
+  if(ins.second) {
+    sndLru.push_front(name);
+    c.lru = sndLru.begin();
+    } else {
+    sndLru.splice(sndLru.begin(),sndLru,c.lru);
+    sndCacheSize -= c.size;
+    }
+  sndCacheSize += size;
+  c.snd  = snd;
+  c.size = size;
+
+  while(sndCacheSize>sndCacheBudget) {
+    auto lru = sndCache.find(sndLru.back());
+    sndCacheSize -= lru->second.size;
+    sndCache.erase(lru);
+    sndLru.pop_back();
+    }
+  }
+
 GthFont &Resources::implLoadFont(std::string_view name, FontType type, const float scale) {
   std::lock_guard<std::recursive_mutex> g(inst->syncFont);
 
@@ -787,8 +1048,100 @@ const Texture2d* Resources::loadTexture(std::string_view name, bool forceMips) {
   return inst->implLoadTexture(name,forceMips);
   }
 
+const Texture2d* Resources::loadTextureAsync(std::string_view name) {
+  if(Gothic::inst().checkLoading()!=Gothic::LoadState::Idle) {
+    // loading screen - no reason to show incomplete textures afterwards
+    return loadTexture(name);
+    }
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  return inst->implLoadTextureAsync(name);
+  }
+
+void Resources::prioritizeTexture(const Tempest::Texture2d* t, float qDist) {
+  if(inst->texRequestsCount.load()==0)
+    return;
+  std::lock_guard<std::mutex> g(inst->texSync);
+  auto it = inst->texRequests.find(t);
+  if(it==inst->texRequests.end())
+    return;
+  auto& rq = it->second;
+  // re-queue only on significant change, to not flood the queue by moving objects
+  if(qDist>=rq.qDist*0.5f)
+    return;
+  rq.qDist = qDist;
+  inst->texQueue.push({qDist, inst->texRequestSeq++, t});
+  }
+
+Tempest::TextureFormat Resources::textureFormat(const Tempest::Texture2d& t) {
+  std::lock_guard<std::mutex> g(inst->texSync);
+  auto it = inst->texPendingFormat.find(&t);
+  if(it!=inst->texPendingFormat.end())
+    return it->second;
+  return t.format();
+  }
+
+void Resources::commitTextures() {
+  std::vector<AsyncTexture> ready;
+  {
+  std::lock_guard<std::mutex> g(inst->texSync);
+  if(inst->texReady.empty())
+    return;
+  ready = std::move(inst->texReady);
+  inst->texReady.clear();
+  }
+
+  const uint64_t now = Application::tickCount();
+  uint64_t       latency = 0, latencyMax = 0;
+  {
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  for(auto& i:ready) {
+    const uint64_t dt = now-i.timeStart;
+    latency   += dt;
+    latencyMax = std::max(latencyMax, dt);
+    if(!i.decoded)
+      continue; // keep placeholder
+    Texture2d tex;
+    try {
+      // upload on main thread, under the same lock as synchronous loads
+      tex = inst->dev->texture(i.pm, i.mips);
+      }
+    catch(...) {
+      Log::e("unable to upload texture \"",i.name,"\"");
+      continue;
+      }
+    // placeholder may still be in use by in-flight frames
+    inst->recycled[inst->recycledId].tex.emplace_back(std::move(*i.dst));
+    *i.dst = std::move(tex);
+    }
+  }
+
+  {
+  std::lock_guard<std::mutex> g(inst->texSync);
+  for(auto& i:ready)
+    inst->texPendingFormat.erase(i.dst);
+  auto& st = inst->texStats;
+  st.latency    = (st.latency*st.loaded + latency)/(st.loaded+ready.size());
+  st.latencyMax = std::max(st.latencyMax, latencyMax);
+  st.loaded    += ready.size();
+  st.pending   -= ready.size();
+  }
+  inst->texGeneration.fetch_add(1);
+  }
+
+uint32_t Resources::textureGeneration() {
+  return inst->texGeneration.load();
+  }
+
+Resources::TextureStats Resources::textureStats() {
+  std::lock_guard<std::mutex> g(inst->texSync);
+  auto ret = inst->texStats;
+  ret.decoded = inst->texDecoded.load();
+  ret.staged  = inst->texStaged.load();
+  return ret;
+  }
+
 const Texture2d* Resources::loadTexture(Tempest::Color color) {
-  if(color==Color())
+  if(color==Color() || isHeadless())
     return nullptr;
   std::lock_guard<std::recursive_mutex> g(inst->sync);
   auto& cache = inst->pixCache;
@@ -800,7 +1153,7 @@ const Texture2d* Resources::loadTexture(Tempest::Color color) {
   Pixmap p2(1,1,TextureFormat::RGBA8);
   std::memcpy(p2.data(),iv,4);
 
-  auto t       = std::make_unique<Texture2d>(inst->dev.texture(p2));
+  auto t       = std::make_unique<Texture2d>(inst->dev->texture(p2));
   auto ret     = t.get();
   cache[color] = std::move(t);
   return ret;
@@ -862,12 +1215,14 @@ std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name)
   }
 
 Texture2d Resources::loadTexturePm(const Pixmap &pm) {
+  if(isHeadless())
+    return Texture2d();
   if(pm.isEmpty()) {
     Pixmap p2(1,1,TextureFormat::R8);
     std::memset(p2.data(),0,1);
-    return inst->dev.texture(p2);
+    return inst->dev->texture(p2);
     }
-  return inst->dev.texture(pm);
+  return inst->dev->texture(pm);
   }
 
 Material Resources::loadMaterial(const zenkit::Material& src, bool enableAlphaTest) {
@@ -909,9 +1264,49 @@ const Animation* Resources::loadAnimation(std::string_view name) {
   return ret;
   }
 
-Tempest::Sound Resources::loadSoundBuffer(std::string_view name) {
+std::vector<std::string> Resources::animationSfx() {
+  std::vector<std::string> ret;
+  {
   std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadSoundBuffer(name);
+  for(auto& i:inst->animCache)
+    if(i.second!=nullptr)
+      i.second->soundEffects(ret);
+  }
+  std::sort(ret.begin(),ret.end());
+  ret.erase(std::unique(ret.begin(),ret.end()),ret.end());
+  return ret;
+  }
+
+size_t Resources::soundCacheSize() {
+  std::lock_guard<std::mutex> g(inst->syncSnd);
+  return inst->sndCacheSize;
+  }
+
+Tempest::Sound Resources::loadSoundBuffer(std::string_view name) {
+  if(name.empty())
+    return Tempest::Sound();
+
+  std::string cname = std::string(name);
+  for(auto& c:cname)
+    c = char(std::toupper(c));
+
+  {
+  std::lock_guard<std::mutex> g(inst->syncSnd);
+  auto it = inst->sndCache.find(cname);
+  if(it!=inst->sndCache.end()) {
+    inst->sndLru.splice(inst->sndLru.begin(),inst->sndLru,it->second.lru);
+    return it->second.snd;
+    }
+  }
+
+  size_t size = 0;
+  auto   snd  = inst->implLoadSoundBuffer(cname,size);
+  if(snd.isEmpty())
+    return snd;
+
+  std::lock_guard<std::mutex> g(inst->syncSnd);
+  inst->implCacheSound(cname,snd,size);
+  return snd;
   }
 
 Dx8::PatternList Resources::loadDxMusic(std::string_view name) {
@@ -937,6 +1332,7 @@ const Resources::VobTree* Resources::loadVobBundle(std::string_view name) {
 void Resources::resetRecycled(uint8_t fId) {
   std::lock_guard<std::recursive_mutex> g(inst->sync);
   inst->recycledId = fId;
+  inst->recycled[fId].tex.clear();
   inst->recycled[fId].ssbo.clear();
   inst->recycled[fId].img.clear();
   inst->recycled[fId].att.clear();
@@ -988,6 +1384,7 @@ void Resources::recycle(Tempest::AccelerationStructure&& rtas) {
   }
 
 const Resources::VobTree* Resources::implLoadVobBundle(std::string_view filename) {
+  PROFILE_SCOPE("load: vob bundle");
   auto cname = std::string(filename);
   auto i     = zenCache.find(cname);
   if(i!=zenCache.end())
@@ -1149,5 +1546,5 @@ Tempest::VertexBuffer<Resources::Vertex> Resources::sphere(int passCount, float
     v.pos[2] *= R;
     }
 
-  return dev.vbo(r);
+  return dev->vbo(r);
   }
@@ -2,6 +2,7 @@
 
 #include <Tempest/Font>
 #include <Tempest/Texture2d>
+#include <Tempest/Pixmap>
 #include <Tempest/Device>
 #include <Tempest/SoundDevice>
 
@@ -11,6 +12,12 @@
 #include <tuple>
 #include <string_view>
 #include <map>
+#include <list>
+#include <limits>
+#include <queue>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
 
 #include "graphics/material.h"
 #include "sound/soundfx.h"
@@ -27,6 +34,10 @@ class PhysicMeshShape;
 class PfxEmitterMesh;
 class GthFont;
 
+namespace Tempest {
+class IDevice;
+}
+
 namespace Dx8 {
 class DirectMusic;
 class PatternList;
@@ -35,6 +46,8 @@ class PatternList;
 class Resources final {
   public:
     explicit Resources(Tempest::Device& device);
+    // headless: no gpu objects are created, textures are not loaded
+    Resources();
     ~Resources();
 
     enum class FontType : uint8_t {
@@ -81,7 +94,17 @@ class Resources final {
 
     using VobTree = std::vector<std::shared_ptr<zenkit::VirtualObject>>;
 
-    static Tempest::Device&          device() { return inst->dev; }
+    struct TextureStats {
+      size_t   pending    = 0;
+      size_t   loaded     = 0;
+      uint64_t latency    = 0; // average, ms
+      uint64_t latencyMax = 0;
+      uint64_t decoded    = 0;
+      uint64_t staged     = 0; // bytes, copied to intermediate buffers (dds, rgba) before decoding
+      };
+
+    static Tempest::Device&          device() { return *inst->dev; }
+    static bool                      isHeadless() { return inst->dev==nullptr; }
     static const char*               renderer();
     static void                      mountWork(const std::filesystem::path& path);
     static void                      loadVdfs(const std::vector<std::u16string> &modvdfs, bool modFilter);
@@ -100,6 +123,12 @@ class Resources final {
     static const Tempest::Texture2d* loadTexture(std::string_view name, bool forceMips = false);
     static const Tempest::Texture2d* loadTexture(Tempest::Color color);
     static const Tempest::Texture2d* loadTexture(std::string_view name, int32_t v, int32_t c);
+    static const Tempest::Texture2d* loadTextureAsync(std::string_view name);
+    static void                      prioritizeTexture(const Tempest::Texture2d* t, float qDist);
+    static Tempest::TextureFormat    textureFormat(const Tempest::Texture2d& t);
+    static void                      commitTextures();
+    static uint32_t                  textureGeneration();
+    static TextureStats              textureStats();
     static       Tempest::Texture2d  loadTexturePm(const Tempest::Pixmap& pm);
     static auto                      loadTextureAnim(std::string_view name) -> std::vector<const Tempest::Texture2d*>;
     static       Material            loadMaterial(const zenkit::Material& src, bool enableAlphaTest);
@@ -110,6 +139,9 @@ class Resources final {
     static const Skeleton*           loadSkeleton   (std::string_view name);
     static const Animation*          loadAnimation  (std::string_view name);
     static Tempest::Sound            loadSoundBuffer(std::string_view name);
+    static std::vector<std::string>  animationSfx();
+    static size_t                    soundCacheSize();
+    static size_t                    soundCacheBudget() { return sndCacheBudget; }
 
     static Dx8::PatternList          loadDxMusic(std::string_view name);
     static DmSegment*                loadMusicSegment(char const* name);
@@ -118,22 +150,22 @@ class Resources final {
     static const VobTree*            loadVobBundle(std::string_view name);
 
     template<class V>
-    static Tempest::VertexBuffer<V>  vbo(const V* data,size_t sz){ return inst->dev.vbo(data,sz); }
+    static Tempest::VertexBuffer<V>  vbo(const V* data,size_t sz){ return isHeadless() ? Tempest::VertexBuffer<V>() : inst->dev->vbo(data,sz); }
 
     template<class I>
-    static Tempest::IndexBuffer<I>   ibo(const I* data,size_t sz){ return inst->dev.ibo(data,sz); }
+    static Tempest::IndexBuffer<I>   ibo(const I* data,size_t sz){ return isHeadless() ? Tempest::IndexBuffer<I>() : inst->dev->ibo(data,sz); }
 
-    static Tempest::StorageBuffer    ssbo(const void* data, size_t size)         { return inst->dev.ssbo(data,size); }
-    static Tempest::StorageBuffer    ssbo(Tempest::Uninitialized_t, size_t size) { return inst->dev.ssbo(Tempest::Uninitialized,size); }
+    static Tempest::StorageBuffer    ssbo(const void* data, size_t size)         { return isHeadless() ? Tempest::StorageBuffer() : inst->dev->ssbo(data,size); }
+    static Tempest::StorageBuffer    ssbo(Tempest::Uninitialized_t, size_t size) { return isHeadless() ? Tempest::StorageBuffer() : inst->dev->ssbo(Tempest::Uninitialized,size); }
 
     template<class V, class I>
     static Tempest::AccelerationStructure
                                      blas(const Tempest::VertexBuffer<V>& b,
                                           const Tempest::IndexBuffer<I>&  i,
                                           size_t offset, size_t size){
-      if(!inst->dev.properties().raytracing.rayQuery)
+      if(isHeadless() || !inst->dev->properties().raytracing.rayQuery)
         return Tempest::AccelerationStructure();
-      return inst->dev.blas(b,i,offset,size);
+      return inst->dev->blas(b,i,offset,size);
       }
 
     static void resetRecycled(uint8_t fId);
@@ -183,13 +215,19 @@ class Resources final {
     void                  detectVdf(std::vector<Archive>& ret, const std::u16string& root);
 
     Tempest::Texture2d*   implLoadTexture(std::string_view cname, bool forceMips);
+    Tempest::Texture2d*   implLoadTextureAsync(std::string_view cname);
+    bool                  implTextureHint(std::string_view name, Tempest::TextureFormat& frm);
+    void                  asyncTextureLoop();
     Tempest::Texture2d    implLoadTextureUncached(std::string_view name, bool forceMips);
-    Tempest::Texture2d    implLoadTextureUncached(std::string_view name, zenkit::Read& data, bool forceMips);
+    bool                  implLoadPixmap(std::string_view name, bool forceMips, Tempest::Pixmap& pm, bool& mips);
+    bool                  implLoadPixmap(zenkit::Read& data, bool forceMips, Tempest::Pixmap& pm, bool& mips);
+    void                  implDecodeTexture(Tempest::IDevice& rd, bool forceMips, Tempest::Pixmap& pm, bool& mips);
     ProtoMesh*            implLoadMesh(std::string_view name);
     std::unique_ptr<ProtoMesh> implLoadMeshMain(std::string name);
     std::unique_ptr<Animation> implLoadAnimation(std::string name);
     ProtoMesh*            implDecalMesh(const zenkit::VisualDecal& decal);
-    Tempest::Sound        implLoadSoundBuffer(std::string_view name);
+    Tempest::Sound        implLoadSoundBuffer(std::string_view name, size_t& size);
+    void                  implCacheSound(const std::string& name, const Tempest::Sound& snd, size_t size);
     Dx8::PatternList      implLoadDxMusic(std::string_view name);
     DmSegment*            implLoadMusicSegment(char const* name);
     GthFont&              implLoadFont(std::string_view fname, FontType type, const float scale);
@@ -225,7 +263,7 @@ class Resources final {
         }
       };
 
-    Tempest::Device&                  dev;
+    Tempest::Device*                  dev = nullptr;
     Tempest::SoundDevice              sound;
 
     std::recursive_mutex              sync;
@@ -233,10 +271,33 @@ class Resources final {
     DmLoader*                         dmLoader = nullptr;
     zenkit::Vfs                       gothicAssets;
 
-    std::vector<uint8_t>              fBuff, ddsBuf;
     Tempest::IndexBuffer<uint16_t>    cube;
 
+    struct AsyncTexture {
+      std::string         name;
+      Tempest::Texture2d* dst       = nullptr;
+      Tempest::Pixmap     pm;   // decoded by texLoader, uploaded on main thread
+      bool                mips      = false;
+      bool                decoded   = false;
+      uint64_t            timeStart = 0;
+      float               qDist     = std::numeric_limits<float>::max(); // squared distance to camera
+      };
+
+    // entry of loader queue; stale entries (request already taken) are skipped by texLoader
+    struct AsyncTexturePriority {
+      float                     qDist = 0;
+      uint64_t                  seq   = 0;
+      const Tempest::Texture2d* dst   = nullptr;
+      bool operator < (const AsyncTexturePriority& other) const {
+        // std::priority_queue is max-heap: nearest first, FIFO for equal distance
+        if(qDist!=other.qDist)
+          return qDist>other.qDist;
+        return seq>other.seq;
+        }
+      };
+
     struct DeleteQueue {
+      std::vector<Tempest::Texture2d>       tex;
       std::vector<Tempest::StorageBuffer>   ssbo;
       std::vector<Tempest::StorageImage>    img;
       std::vector<Tempest::Attachment>      att;
@@ -248,6 +309,21 @@ class Resources final {
     uint8_t     recycledId = 0;
 
     TextureCache                                                      texCache;
+
+    std::thread                                                       texLoader;
+    std::mutex                                                        texSync;
+    std::condition_variable                                           texCnd;
+    bool                                                              texLoaderExit = false;
+    std::priority_queue<AsyncTexturePriority>                         texQueue;
+    std::unordered_map<const Tempest::Texture2d*,AsyncTexture>        texRequests;
+    std::atomic<size_t>                                               texRequestsCount{0};
+    uint64_t                                                          texRequestSeq = 0;
+    std::vector<AsyncTexture>                                         texReady;
+    std::unordered_map<const Tempest::Texture2d*,Tempest::TextureFormat> texPendingFormat;
+    std::atomic<uint32_t>                                             texGeneration{0};
+    TextureStats                                                      texStats;
+    std::atomic<uint64_t>                                             texDecoded{0};
+    std::atomic<uint64_t>                                             texStaged{0};
     std::map<Tempest::Color,std::unique_ptr<Tempest::Texture2d>,Less> pixCache;
     std::unordered_map<std::string,std::unique_ptr<ProtoMesh>>        aniMeshCache;
     std::unordered_map<DecalK,std::unique_ptr<ProtoMesh>,Hash>        decalMeshCache;
@@ -257,6 +333,17 @@ class Resources final {
     std::unordered_map<std::string,std::unique_ptr<PfxEmitterMesh>>   emiMeshCache;
     std::unordered_map<std::string,std::unique_ptr<VobTree>>          zenCache;
 
+    struct SoundCacheItem {
+      Tempest::Sound                   snd;
+      size_t                           size = 0; // decoded pcm bytes
+      std::list<std::string>::iterator lru;
+      };
+    std::mutex                                                        syncSnd;
+    std::unordered_map<std::string,SoundCacheItem>                    sndCache;
+    std::list<std::string>                                            sndLru; // front - most recently used
+    size_t                                                            sndCacheSize = 0;
+    static const size_t                                               sndCacheBudget;
+
     std::recursive_mutex                                              syncFont;
     std::unordered_map<FontK,std::unique_ptr<GthFont>,Hash>           gothicFnt;
   };
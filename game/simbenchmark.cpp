@@ -0,0 +1,183 @@
+#include "simbenchmark.h"
+
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "world/objects/npc.h"
+#include "utils/profiler.h"
+#include "utils/string_frm.h"
+#include "commandline.h"
+#include "gothic.h"
+
+using namespace Tempest;
+
+SimBenchmark::SimBenchmark(const CommandLine& cmd)
+  :world(cmd.wrldDef), hours(cmd.simBenchmarkHours()), step(cmd.simBenchmarkStep()), crowd(cmd.simBenchmarkCrowd()),
+   seed(cmd.simBenchmarkSeed()) {
+  if(world.empty())
+    world = std::string(Gothic::inst().defaultWorld());
+  }
+
+int SimBenchmark::exec() {
+  auto& gothic = Gothic::inst();
+  string_frm info("Simulation benchmark: world = \"", world, "\" hours = ", hours, " step = ", unsigned(step), " ms",
+                  " seed = ", unsigned(seed));
+  Log::i(info.c_str());
+
+  // before session is created: script vm takes its seed on construction
+  gothic.setRandomSeed(seed);
+
+  try {
+    gothic.setGame(std::make_unique<GameSession>(world));
+    }
+  catch(const std::exception& e) {
+    Log::e("Simulation benchmark: unable to load world - ", e.what());
+    return -1;
+    }
+
+  if(gothic.gameSession()==nullptr || gothic.world()==nullptr) {
+    Log::e("Simulation benchmark: unable to load world");
+    return -1;
+    }
+
+  if(crowd>0) {
+    // keep player alive, so crowd stays in combat for the whole run
+    gothic.setGodMode(true);
+    spawnCrowd(*gothic.world(), crowd);
+    }
+  const auto percBegin = gothic.world()->perception().stats();
+  const auto tierBegin = gothic.world()->tierStats();
+
+  const int64_t hourMs = gtime(int64_t(0),int64_t(1),int64_t(0)).toInt();
+  const int64_t until  = gothic.gameSession()->time().toInt() + int64_t(double(hours)*double(hourMs));
+
+  std::unordered_map<std::string_view,uint64_t> subsystems;
+  if(!Profiler::isAvailable()) {
+    // release build: scoped timers are compiled out, breakdown would be silently empty
+    Log::e("Simulation benchmark: profiler is not available in this build, per-subsystem timings are disabled;"
+           " configure with -DOPENGOTHIC_PROFILER=ON");
+    }
+  Profiler::setEnabled(true);
+
+  uint64_t   ticks = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  while(true) {
+    auto game = gothic.gameSession();
+    if(game==nullptr || game->time().toInt()>=until)
+      break;
+    gothic.tick(step);
+    gothic.updateAnimation(step);
+    ++ticks;
+
+    Profiler::frame();
+    for(auto& i:Profiler::frameStats())
+      subsystems[i.name] += i.timeUs;
+    }
+  const auto end = std::chrono::steady_clock::now();
+  Profiler::setEnabled(false);
+
+  const double sec = std::chrono::duration<double>(end-begin).count();
+  const double tps = sec>0 ? double(ticks)/sec : 0.0;
+  string_frm total("Simulation benchmark: ticks = ", size_t(ticks), " time = ", sec, " s ticks/sec = ", tps);
+  Log::i(total.c_str());
+
+  std::vector<std::pair<std::string_view,uint64_t>> sorted(subsystems.begin(), subsystems.end());
+  std::sort(sorted.begin(), sorted.end(), [](auto& a, auto& b){ return a.second>b.second; });
+  for(auto& i:sorted) {
+    string_frm sub("  ", i.first, " = ", double(i.second)/1000.0, " ms");
+    Log::i(sub.c_str());
+    }
+
+  if(auto w = gothic.world()) {
+    auto& perc = w->perception().stats();
+    string_frm pstat("Simulation benchmark: perception queries = ", size_t(perc.queries-percBegin.queries),
+                     " candidates = ", size_t(perc.candidates-percBegin.candidates),
+                     " senses = ", size_t(perc.senses-percBegin.senses),
+                     " cached = ", size_t(perc.cacheHits-percBegin.cacheHits));
+    Log::i(pstat.c_str());
+    string_frm dstat("Simulation benchmark: passive perception dispatched = ", size_t(perc.dispatched-percBegin.dispatched),
+                     " culled = ", size_t(perc.culled-percBegin.culled),
+                     " duplicates = ", size_t(perc.duplicates-percBegin.duplicates));
+    Log::i(dstat.c_str());
+
+    static const char* tierName[WorldObjects::TierStats::Count] = {"player", "near", "far", "far2", "far2 coarse"};
+    auto& tier = w->tierStats();
+    for(size_t i=0; i<WorldObjects::TierStats::Count; ++i) {
+      const uint64_t cnt = tier.ticks [i]-tierBegin.ticks [i];
+      const uint64_t ns  = tier.timeNs[i]-tierBegin.timeNs[i];
+      string_frm tstat("Simulation benchmark: npc tier ", tierName[i], " ticks = ", size_t(cnt),
+                       " time = ", double(ns)/1000000.0, " ms");
+      Log::i(tstat.c_str());
+      }
+    }
+
+  if(auto w = gothic.world()) {
+    char hash[32] = {};
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(stateHash(*w)));
+    Log::i("Simulation benchmark: state hash = ", hash);
+    }
+
+  gothic.clearGame();
+  return 0;
+  }
+
+void SimBenchmark::spawnCrowd(World& world, uint32_t count) {
+  static const char* instances[] = {"Wolf", "Scavenger"};
+
+  size_t id = size_t(-1);
+  for(auto name:instances) {
+    id = world.script().findSymbolIndex(name);
+    if(id!=size_t(-1))
+      break;
+    }
+  auto pl = world.player();
+  if(id==size_t(-1) || pl==nullptr) {
+    Log::e("Simulation benchmark: unable to spawn crowd");
+    return;
+    }
+
+  // square around the player, 1.5m apart
+  const uint32_t side  = uint32_t(std::ceil(std::sqrt(float(count))));
+  const float    space = 150;
+  const auto     at    = pl->position();
+  for(uint32_t i=0; i<count; ++i) {
+    float dx = (float(i%side) - float(side)*0.5f)*space;
+    float dz = (float(i/side) - float(side)*0.5f)*space;
+    world.addNpc(id, at + Tempest::Vec3(dx,0,dz));
+    }
+  string_frm info("Simulation benchmark: spawned crowd of ", unsigned(count), " npc");
+  Log::i(info.c_str());
+  }
+
+uint64_t SimBenchmark::stateHash(World& world) {
+  // FNV-1a over the simulation-relevant part of the world state
+  uint64_t h = 0xcbf29ce484222325;
+  auto mix = [&h](int64_t v) {
+    for(int i=0; i<8; ++i) {
+      h ^= uint64_t(v >> (i*8)) & 0xFF;
+      h *= 0x100000001b3;
+      }
+    };
+
+  mix(world.time().toInt());
+  const uint32_t count = world.npcCount();
+  mix(count);
+  for(uint32_t i=0; i<count; ++i) {
+    auto npc = world.npcById(i);
+    if(npc==nullptr)
+      continue;
+    auto pos = npc->position();
+    mix(int64_t(pos.x));
+    mix(int64_t(pos.y));
+    mix(int64_t(pos.z));
+    mix(npc->attribute(ATR_HITPOINTS));
+    mix(npc->isDead() ? 1 : 0);
+    }
+  return h;
+  }
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class CommandLine;
+class World;
+
+// Runs game simulation for a fixed amount of in-game time, without graphics device, window and rendering.
+// Reports ticks per second, time per instrumented subsystem and hash of the final world state.
+class SimBenchmark final {
+  public:
+    explicit SimBenchmark(const CommandLine& cmd);
+
+    int exec();
+
+  private:
+    static uint64_t stateHash(World& world);
+    static void     spawnCrowd(World& world, uint32_t count);
+
+    std::string world;
+    float       hours = 0;
+    uint32_t    step  = 20;
+    uint32_t    crowd = 0;
+    uint32_t    seed  = 0;
+  };
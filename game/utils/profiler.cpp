@@ -0,0 +1,180 @@
+#include "profiler.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+using namespace Tempest;
+
+struct Profiler::Event {
+  const char* name  = nullptr;
+  uint64_t    begin = 0;
+  uint64_t    end   = 0;
+  };
+
+struct Profiler::ThreadLog {
+  static constexpr size_t RingSize = 16*1024;
+
+  std::mutex         sync;
+  uint32_t           tid  = 0;
+  uint64_t           head = 0; // total events written
+  uint64_t           read = 0; // events consumed by frame()
+  std::vector<Event> ring = std::vector<Event>(RingSize);
+  };
+
+struct Profiler::State {
+  std::atomic_bool                        enabled{false};
+  std::chrono::steady_clock::time_point   epoch = std::chrono::steady_clock::now();
+
+  std::mutex                              sync;
+  std::vector<std::shared_ptr<ThreadLog>> logs;
+  std::vector<Stat>                       stats;
+  };
+
+Profiler::Scope::Scope(const char* name) {
+  if(!Profiler::isEnabled())
+    return;
+  this->name  = name;
+  this->begin = Profiler::now();
+  }
+
+Profiler::Scope::~Scope() {
+  if(name==nullptr)
+    return;
+  const uint64_t end = Profiler::now();
+
+  auto& log = Profiler::threadLog();
+  std::lock_guard<std::mutex> guard(log.sync);
+  log.ring[size_t(log.head%ThreadLog::RingSize)] = Event{name,begin,end};
+  log.head++;
+  }
+
+Profiler::State& Profiler::state() {
+  static State st;
+  return st;
+  }
+
+Profiler::ThreadLog& Profiler::threadLog() {
+  thread_local std::shared_ptr<ThreadLog> log;
+  if(log==nullptr) {
+    auto& st = state();
+    log = std::make_shared<ThreadLog>();
+    std::lock_guard<std::mutex> guard(st.sync);
+    log->tid = uint32_t(st.logs.size()+1);
+    st.logs.push_back(log);
+    }
+  return *log;
+  }
+
+uint64_t Profiler::now() {
+  auto dt = std::chrono::steady_clock::now() - state().epoch;
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count());
+  }
+
+bool Profiler::isAvailable() {
+#if defined(OPENGOTHIC_PROFILER_ENABLED)
+  return true;
+#else
+  return false;
+#endif
+  }
+
+bool Profiler::isEnabled() {
+#if defined(OPENGOTHIC_PROFILER_ENABLED)
+  return state().enabled.load(std::memory_order_relaxed);
+#else
+  return false;
+#endif
+  }
+
+void Profiler::setEnabled(bool e) {
+  auto& st = state();
+  st.enabled.store(e && isAvailable());
+
+  std::lock_guard<std::mutex> guard(st.sync);
+  st.stats.clear();
+  }
+
+void Profiler::frame() {
+  if(!isEnabled())
+    return;
+
+  auto& st = state();
+  std::lock_guard<std::mutex> guard(st.sync);
+
+  std::unordered_map<std::string_view,Stat> acc;
+  for(auto& log:st.logs) {
+    std::lock_guard<std::mutex> lguard(log->sync);
+    uint64_t begin = log->read;
+    if(log->head-begin>ThreadLog::RingSize)
+      begin = log->head-ThreadLog::RingSize;
+    for(uint64_t i=begin; i<log->head; ++i) {
+      auto& e = log->ring[size_t(i%ThreadLog::RingSize)];
+      auto& s = acc[e.name];
+      s.name    = e.name;
+      s.timeUs += (e.end-e.begin);
+      s.calls  += 1;
+      }
+    log->read = log->head;
+    }
+
+  st.stats.clear();
+  for(auto& i:acc) {
+    st.stats.push_back(i.second);
+    st.stats.back().timeUs /= 1000;
+    }
+  std::sort(st.stats.begin(), st.stats.end(), [](const Stat& a, const Stat& b){
+    return a.timeUs>b.timeUs;
+    });
+  }
+
+std::vector<Profiler::Stat> Profiler::frameStats() {
+  auto& st = state();
+  std::lock_guard<std::mutex> guard(st.sync);
+  return st.stats;
+  }
+
+bool Profiler::dumpTrace(std::string_view path) {
+  auto& st = state();
+
+  std::stringstream s;
+  s << std::fixed << std::setprecision(3);
+  s << "{\"traceEvents\":[";
+  bool first = true;
+  std::lock_guard<std::mutex> guard(st.sync);
+  for(auto& log:st.logs) {
+    std::lock_guard<std::mutex> lguard(log->sync);
+    uint64_t begin = 0;
+    if(log->head>ThreadLog::RingSize)
+      begin = log->head-ThreadLog::RingSize;
+    for(uint64_t i=begin; i<log->head; ++i) {
+      auto& e = log->ring[size_t(i%ThreadLog::RingSize)];
+      if(!first)
+        s << ",";
+      first = false;
+      s << "\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << log->tid
+        << ",\"ts\":" << double(e.begin)/1000.0 << ",\"dur\":" << double(e.end-e.begin)/1000.0 << "}";
+      }
+    }
+  s << "\n]}\n";
+
+  try {
+    auto str = s.str();
+    WFile f(std::string(path).c_str());
+    f.write(str.data(),str.size());
+    f.flush();
+    }
+  catch(...) {
+    Log::e("unable to write profiler trace: \"",path,"\"");
+    return false;
+    }
+  return true;
+  }
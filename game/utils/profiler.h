@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if !defined(NDEBUG) || defined(OPENGOTHIC_PROFILER)
+#define OPENGOTHIC_PROFILER_ENABLED 1
+#endif
+
+// Scoped CPU timers. Each thread records into own ring-buffer; collection is enabled at runtime
+// via console ("toggle profiler"). In release builds timers are compiled out, unless OPENGOTHIC_PROFILER is set.
+class Profiler final {
+  public:
+    struct Stat {
+      const char* name   = nullptr;
+      uint64_t    timeUs = 0;
+      uint32_t    calls  = 0;
+      };
+
+    class Scope final {
+      public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+      private:
+        const char* name  = nullptr;
+        uint64_t    begin = 0;
+      };
+
+    static bool isAvailable();
+    static bool isEnabled();
+    static void setEnabled(bool e);
+
+    static void frame();
+    static auto frameStats() -> std::vector<Stat>;
+
+    static bool dumpTrace(std::string_view path);
+
+  private:
+    struct Event;
+    struct ThreadLog;
+    struct State;
+
+    static uint64_t   now();
+    static State&     state();
+    static ThreadLog& threadLog();
+  };
+
+#if defined(OPENGOTHIC_PROFILER_ENABLED)
+#define PROFILER_CONCAT2(a,b) a##b
+#define PROFILER_CONCAT(a,b)  PROFILER_CONCAT2(a,b)
+#define PROFILE_SCOPE(name)   Profiler::Scope PROFILER_CONCAT(profilerScope,__LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
@@ -0,0 +1,202 @@
+#include "rangeallocator.h"
+
+#include <bit>
+#include <cassert>
+
+RangeAllocator::RangeAllocator() {
+  clear();
+  }
+
+void RangeAllocator::clear() {
+  nodes.clear();
+  freeNodes.clear();
+  byBegin.clear();
+  byEnd.clear();
+  flBitmap  = 0;
+  totalFree = 0;
+  for(uint32_t i=0; i<FlCount; ++i) {
+    slBitmap[i] = 0;
+    for(uint32_t r=0; r<SlCount; ++r)
+      head[i][r] = nil;
+    }
+  }
+
+size_t RangeAllocator::alloc(size_t size) {
+  if(size==0)
+    return npos;
+
+  uint32_t fl = 0, sl = 0;
+  uint32_t id = nil;
+
+  mappingSearch(size,fl,sl);
+  if(findSuitable(fl,sl)) {
+    id = head[fl][sl];
+    } else {
+    // rounded-up class is empty - try blocks of the same class as requested size
+    mapping(size,fl,sl);
+    id = findInList(fl,sl,size);
+    }
+  if(id==nil)
+    return npos;
+
+  remove(id);
+  const size_t begin = nodes[id].begin;
+  const size_t rest  = nodes[id].size - size;
+  if(rest>0) {
+    nodes[id].begin += size;
+    nodes[id].size   = rest;
+    insert(id);
+    } else {
+    freeNodes.push_back(id);
+    }
+  return begin;
+  }
+
+bool RangeAllocator::allocAt(size_t begin, size_t size) {
+  if(size==0)
+    return true;
+  // NOTE: linear search - expected to be used rarely, for fixed reservations
+  for(uint32_t id=0; id<nodes.size(); ++id) {
+    auto it = byBegin.find(nodes[id].begin);
+    if(it==byBegin.end() || it->second!=id)
+      continue; // recycled node
+    const size_t nb = nodes[id].begin;
+    const size_t ne = nb + nodes[id].size;
+    if(begin<nb || ne<begin+size)
+      continue;
+
+    remove(id);
+    freeNodes.push_back(id);
+    if(nb<begin)
+      insert(mkNode(nb,begin-nb));
+    if(begin+size<ne)
+      insert(mkNode(begin+size,ne-begin-size));
+    return true;
+    }
+  return false;
+  }
+
+void RangeAllocator::free(size_t begin, size_t size) {
+  if(size==0)
+    return;
+
+  // coalesce with neighbours
+  if(auto l = byEnd.find(begin); l!=byEnd.end()) {
+    const uint32_t id = l->second;
+    remove(id);
+    begin -= nodes[id].size;
+    size  += nodes[id].size;
+    freeNodes.push_back(id);
+    }
+  if(auto r = byBegin.find(begin+size); r!=byBegin.end()) {
+    const uint32_t id = r->second;
+    remove(id);
+    size += nodes[id].size;
+    freeNodes.push_back(id);
+    }
+
+  insert(mkNode(begin,size));
+  }
+
+void RangeAllocator::mapping(size_t size, uint32_t& fl, uint32_t& sl) {
+  if(size<SmallMax) {
+    fl = 0;
+    sl = uint32_t(size);
+    return;
+    }
+  const uint32_t msb = uint32_t(std::bit_width(size)) - 1;
+  fl = msb - SlLog2 + 1;
+  sl = uint32_t(size >> (msb - SlLog2)) & (SlCount-1);
+  }
+
+void RangeAllocator::mappingSearch(size_t size, uint32_t& fl, uint32_t& sl) {
+  if(size>=SmallMax) {
+    const uint32_t msb = uint32_t(std::bit_width(size)) - 1;
+    size += (size_t(1) << (msb - SlLog2)) - 1;
+    }
+  mapping(size,fl,sl);
+  }
+
+bool RangeAllocator::findSuitable(uint32_t& fl, uint32_t& sl) const {
+  if(fl>=FlCount)
+    return false;
+
+  uint32_t slMap = (sl<SlCount) ? (slBitmap[fl] & (~0u << sl)) : 0;
+  if(slMap==0) {
+    if(fl+1>=FlCount)
+      return false;
+    const uint64_t flMap = flBitmap & (~uint64_t(0) << (fl+1));
+    if(flMap==0)
+      return false;
+    fl    = uint32_t(std::countr_zero(flMap));
+    slMap = slBitmap[fl];
+    }
+  sl = uint32_t(std::countr_zero(slMap));
+  return true;
+  }
+
+uint32_t RangeAllocator::findInList(uint32_t fl, uint32_t sl, size_t size) const {
+  for(uint32_t i=head[fl][sl]; i!=nil; i=nodes[i].next) {
+    if(nodes[i].size>=size)
+      return i;
+    }
+  return nil;
+  }
+
+uint32_t RangeAllocator::mkNode(size_t begin, size_t size) {
+  uint32_t id = nil;
+  if(!freeNodes.empty()) {
+    id = freeNodes.back();
+    freeNodes.pop_back();
+    } else {
+    id = uint32_t(nodes.size());
+    nodes.emplace_back();
+    }
+  nodes[id].begin = begin;
+  nodes[id].size  = size;
+  return id;
+  }
+
+void RangeAllocator::insert(uint32_t id) {
+  auto& n = nodes[id];
+  uint32_t fl = 0, sl = 0;
+  mapping(n.size,fl,sl);
+
+  n.prev = nil;
+  n.next = head[fl][sl];
+  if(n.next!=nil)
+    nodes[n.next].prev = id;
+  head[fl][sl] = id;
+
+  flBitmap     |= (uint64_t(1) << fl);
+  slBitmap[fl] |= (1u << sl);
+
+  byBegin[n.begin]      = id;
+  byEnd[n.begin+n.size] = id;
+  totalFree += n.size;
+  }
+
+void RangeAllocator::remove(uint32_t id) {
+  auto& n = nodes[id];
+  uint32_t fl = 0, sl = 0;
+  mapping(n.size,fl,sl);
+
+  if(n.prev!=nil)
+    nodes[n.prev].next = n.next; else
+    head[fl][sl] = n.next;
+  if(n.next!=nil)
+    nodes[n.next].prev = n.prev;
+
+  if(head[fl][sl]==nil) {
+    slBitmap[fl] &= ~(1u << sl);
+    if(slBitmap[fl]==0)
+      flBitmap &= ~(uint64_t(1) << fl);
+    }
+
+  byBegin.erase(n.begin);
+  byEnd  .erase(n.begin+n.size);
+  assert(totalFree>=n.size);
+  totalFree -= n.size;
+  n.prev = nil;
+  n.next = nil;
+  }
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+// Two-level segregated fit (TLSF-like) allocator of abstract ranges [begin, begin+size)
+// Does not own the memory: if nothing fits, caller is expected to grow the storage by itself.
+class RangeAllocator final {
+  public:
+    RangeAllocator();
+
+    static constexpr size_t npos = size_t(-1);
+
+    size_t alloc  (size_t size);
+    bool   allocAt(size_t begin, size_t size);
+    void   free   (size_t begin, size_t size);
+    void   clear();
+
+    size_t freeSize() const { return totalFree; }
+
+  private:
+    static constexpr uint32_t SlLog2   = 4;
+    static constexpr uint32_t SlCount  = 1u << SlLog2;
+    static constexpr uint32_t FlCount  = 64 - SlLog2 + 1;
+    static constexpr uint32_t SmallMax = SlCount;
+    static constexpr uint32_t nil      = uint32_t(-1);
+
+    struct Node {
+      size_t   begin = 0;
+      size_t   size  = 0;
+      uint32_t prev  = nil;
+      uint32_t next  = nil;
+      };
+
+    static void mapping      (size_t size, uint32_t& fl, uint32_t& sl);
+    static void mappingSearch(size_t size, uint32_t& fl, uint32_t& sl);
+
+    bool        findSuitable (uint32_t& fl, uint32_t& sl) const;
+    uint32_t    findInList   (uint32_t fl, uint32_t sl, size_t size) const;
+
+    uint32_t    mkNode       (size_t begin, size_t size);
+    void        insert       (uint32_t id);
+    void        remove       (uint32_t id);
+
+    std::vector<Node>                    nodes;
+    std::vector<uint32_t>                freeNodes;
+    std::unordered_map<size_t,uint32_t>  byBegin, byEnd;
+
+    uint64_t                             flBitmap = 0;
+    uint32_t                             slBitmap[FlCount] = {};
+    uint32_t                             head[FlCount][SlCount] = {};
+    size_t                               totalFree = 0;
+  };
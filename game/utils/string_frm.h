@@ -109,10 +109,10 @@ class alignas(64) string_frm {
       }
 
     void implWrite(char* out, size_t maxSz, size_t& at, const char* arg) {
+      // keep counting past maxSz: first pass measures the size for heap storage
       for(size_t i=0; arg[i]; ++i) {
-        if(at>=maxSz)
-          break;
-        out[at] = arg[i];
+        if(at<maxSz)
+          out[at] = arg[i];
         at++;
         }
       }
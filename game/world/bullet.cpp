@@ -39,11 +39,15 @@ Bullet::~Bullet() {
 
 void Bullet::setPosition(const Tempest::Vec3& p) {
   obj->setPosition(p);
+  lerpPrev = p;
+  lerpCur  = p;
   updateMatrix();
   }
 
 void Bullet::setPosition(float x, float y, float z) {
   obj->setPosition(Vec3(x,y,z));
+  lerpPrev = Vec3(x,y,z);
+  lerpCur  = lerpPrev;
   updateMatrix();
   }
 
@@ -154,10 +158,35 @@ void Bullet::onCollide(Npc& npc) {
   onStop();
   }
 
+void Bullet::updateLerp(float alpha) {
+  if(obj==nullptr || lerpPrev==lerpCur)
+    return;
+  if(lerpTick!=wrld->tickCount()) {
+    // not moved by last step - settle on actual position
+    lerpPrev = lerpCur;
+    setViewMatrix(lerpCur);
+    return;
+    }
+  setViewMatrix(lerpPrev + (lerpCur-lerpPrev)*alpha);
+  }
+
 void Bullet::updateMatrix() {
   if(obj==nullptr)
     return;
+  const uint64_t now = wrld->tickCount();
+  if(lerpTick!=now) {
+    lerpPrev = lerpCur;
+    lerpTick = now;
+    }
+  lerpCur = obj->position();
+  setViewMatrix(lerpCur);
+  }
+
+void Bullet::setViewMatrix(const Vec3& at) {
   auto mat = obj->matrix();
+  mat.set(3,0,at.x);
+  mat.set(3,1,at.y);
+  mat.set(3,2,at.z);
   view.setObjMatrix(mat);
   // HACK: lighting bolt spell
   mat.rotateOY(90);
@@ -56,6 +56,7 @@ class Bullet final : public DynamicWorld::BulletCallback {
 
     bool     isFinished() const;
     float    pathLength() const;
+    void     updateLerp(float alpha);
 
   protected:
     void     onStop() override;
@@ -78,6 +79,11 @@ class Bullet final : public DynamicWorld::BulletCallback {
     uint8_t                   material=0;
     Flg                       flg=NoFlags;
 
+    // bullets move in fixed simulation steps; visual is interpolated in between
+    Tempest::Vec3             lerpPrev, lerpCur;
+    uint64_t                  lerpTick=uint64_t(-1);
+
     void updateMatrix();
+    void setViewMatrix(const Tempest::Vec3& at);
   };
 
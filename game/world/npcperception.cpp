@@ -0,0 +1,178 @@
+#include "npcperception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "game/perceptionmsg.h"
+#include "world/objects/npc.h"
+
+NpcPerception::NpcPerception(const std::vector<Npc*>& npcNear)
+  :npcNear(npcNear) {
+  }
+
+void NpcPerception::begin() {
+  grid.clear();
+  slot.clear();
+  senses.clear();
+  delivered.clear();
+  for(auto& i:inboxes)
+    i.clear();
+  inboxes.resize(npcNear.size());
+  maxRange = 0;
+
+  for(size_t i=0; i<npcNear.size(); ++i) {
+    auto p = npcNear[i]->position();
+    grid.emplace_back(cellKey(cellId(p.x),cellId(p.z)), uint32_t(i));
+    slot[npcNear[i]] = uint32_t(i);
+    maxRange = std::max(maxRange, float(npcNear[i]->handle().senses_range));
+    }
+  std::sort(grid.begin(), grid.end());
+  active = true;
+  }
+
+void NpcPerception::end() {
+  active = false;
+  senses.clear();
+  }
+
+template<class F>
+void NpcPerception::forEachNear(const Tempest::Vec3& pos, float range, F f) {
+  const int32_t x0 = cellId(pos.x-range), x1 = cellId(pos.x+range);
+  const int32_t z0 = cellId(pos.z-range), z1 = cellId(pos.z+range);
+  if(uint64_t(x1-x0+1)*uint64_t(z1-z0+1) > grid.size()) {
+    // range is larger than the crowd - plain scan is cheaper
+    for(auto& i:grid)
+      f(i.second);
+    return;
+    }
+  for(int32_t x=x0; x<=x1; ++x)
+    for(int32_t z=z0; z<=z1; ++z) {
+      const uint64_t key = cellKey(x,z);
+      auto it = std::lower_bound(grid.begin(), grid.end(), std::make_pair(key,uint32_t(0)));
+      for(; it!=grid.end() && it->first==key; ++it)
+        f(it->second);
+      }
+  }
+
+template<class Pred>
+void NpcPerception::collect(Npc& self, float dist, Pred pred) {
+  candidates.clear();
+
+  const float range = float(self.handle().senses_range) + BoundsSlack;
+  const float maxD  = std::min(dist, range*range);
+  auto push = [&](Npc& n) {
+    if(!pred(n))
+      return;
+    const float d = self.qDistTo(n);
+    if(d<maxD)
+      candidates.push_back(Candidate{d,&n});
+    };
+
+  if(!active) {
+    for(auto n:npcNear)
+      push(*n);
+    } else {
+    forEachNear(self.position(), range, [&](uint32_t id) {
+      push(*npcNear[id]);
+      });
+    }
+
+  st.candidates += candidates.size();
+  }
+
+Npc* NpcPerception::nearestEnemy(Npc& self, Npc* current) {
+  st.queries++;
+
+  Npc*  ret  = nullptr;
+  float dist = std::numeric_limits<float>::max();
+  if(current!=nullptr && !current->isDown() && senseNpc(self,*current,true)!=SensesBit::SENSE_NONE) {
+    ret  = current;
+    dist = self.qDistTo(*current);
+    }
+
+  collect(self, dist, [&self](const Npc& n) {
+    return self.isEnemy(n) && !n.isDown() && &n!=&self;
+    });
+  if(auto n = nearestSensed(self))
+    return n;
+  return ret;
+  }
+
+Npc* NpcPerception::nearestBody(Npc& self) {
+  st.queries++;
+
+  collect(self, std::numeric_limits<float>::max(), [](const Npc& n) {
+    return n.isDead();
+    });
+  return nearestSensed(self);
+  }
+
+SensesBit NpcPerception::senseNpc(const Npc& self, const Npc& oth, bool freeLos) {
+  if(!active) {
+    st.senses++;
+    return self.canSenseNpc(oth,freeLos);
+    }
+
+  auto a = slot.find(&self);
+  auto b = slot.find(&oth);
+  if(a==slot.end() || b==slot.end()) {
+    // spawned within this tick
+    st.senses++;
+    return self.canSenseNpc(oth,freeLos);
+    }
+
+  const uint64_t key = (uint64_t(a->second) << 33) | (uint64_t(b->second) << 1) | (freeLos ? 1 : 0);
+  if(auto it = senses.find(key); it!=senses.end()) {
+    st.cacheHits++;
+    return it->second;
+    }
+
+  st.senses++;
+  const auto ret = self.canSenseNpc(oth,freeLos);
+  senses[key] = ret;
+  return ret;
+  }
+
+void NpcPerception::dispatch(uint32_t msgId, const PerceptionMsg& msg, float range) {
+  uint64_t cnt = 0;
+  forEachNear(msg.pos, range, [&](uint32_t id) {
+    // keyed on sender itself: sender may be out of npcNear and have no slot
+    if(!delivered.insert(Delivery{id, msg.what, msg.self}).second) {
+      st.duplicates++;
+      return;
+      }
+    inboxes[id].push_back(msgId);
+    ++cnt;
+    });
+  st.dispatched += cnt;
+  st.culled     += npcNear.size()-cnt;
+  }
+
+const std::vector<uint32_t>& NpcPerception::inbox(const Npc& npc) const {
+  static const std::vector<uint32_t> empty;
+  auto s = slot.find(&npc);
+  if(!active || s==slot.end())
+    return empty;
+  return inboxes[s->second];
+  }
+
+int32_t NpcPerception::cellId(float v) {
+  return int32_t(std::floor(v/CellSize));
+  }
+
+uint64_t NpcPerception::cellKey(int32_t x, int32_t z) {
+  return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(z));
+  }
+
+Npc* NpcPerception::nearestSensed(Npc& self) {
+  // closest first: first npc that can be sensed is the answer, no need to cast rays for the rest
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b){
+    return a.dist<b.dist;
+    });
+  for(auto& c:candidates) {
+    if(senseNpc(self,*c.npc,true)!=SensesBit::SENSE_NONE)
+      return c.npc;
+    }
+  return nullptr;
+  }
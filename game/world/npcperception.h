@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Tempest/Point>
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "game/constants.h"
+
+class Npc;
+class PerceptionMsg;
+
+// Per-tick helper for active perceptions (ASSESSPLAYER, ASSESSENEMY, ASSESSBODY) and passive perception dispatch.
+// Buckets nearby npc's into 2d grid and memorizes results of Npc::canSenseNpc for the duration of one tick,
+// so repeated queries for same pair of npc's do not cast physics rays again.
+// Passive messages are delivered only to npc's in range of the message, at most once per (receiver, sender, type).
+class NpcPerception final {
+  public:
+    explicit NpcPerception(const std::vector<Npc*>& npcNear);
+
+    struct Stats {
+      uint64_t queries    = 0;
+      uint64_t candidates = 0;
+      uint64_t senses     = 0;
+      uint64_t cacheHits  = 0;
+
+      uint64_t dispatched = 0;
+      uint64_t culled     = 0;
+      uint64_t duplicates = 0;
+      };
+
+    void         begin();
+    void         end();
+    bool         isActive() const { return active; }
+
+    Npc*         nearestEnemy(Npc& self, Npc* current);
+    Npc*         nearestBody (Npc& self);
+    SensesBit    senseNpc    (const Npc& self, const Npc& oth, bool freeLos);
+
+    float        maxSensesRange() const { return maxRange; }
+    void         dispatch(uint32_t msgId, const PerceptionMsg& msg, float range);
+    auto         inbox(const Npc& npc) const -> const std::vector<uint32_t>&;
+
+    const Stats& stats() const { return st; }
+
+  private:
+    static constexpr float CellSize = 1000;
+    // canSenseNpc measures distance to center of bounding box, not to npc position
+    static constexpr float BoundsSlack = 1000;
+
+    struct Candidate {
+      float dist = 0;
+      Npc*  npc  = nullptr;
+      };
+
+    struct Delivery {
+      uint32_t   receiver = 0;
+      int32_t    what     = 0;
+      const Npc* sender   = nullptr;
+      bool operator == (const Delivery& other) const = default;
+      };
+    struct DeliveryHash {
+      size_t operator()(const Delivery& d) const {
+        return std::hash<const Npc*>()(d.sender) ^ (size_t(d.receiver) << 8) ^ size_t(uint32_t(d.what));
+        }
+      };
+
+    static int32_t  cellId(float v);
+    static uint64_t cellKey(int32_t x, int32_t z);
+
+    template<class F>
+    void            forEachNear(const Tempest::Vec3& pos, float range, F f);
+    template<class Pred>
+    void            collect(Npc& self, float dist, Pred pred);
+    Npc*            nearestSensed(Npc& self);
+
+    const std::vector<Npc*>&                   npcNear;
+    bool                                       active   = false;
+    float                                      maxRange = 0;
+
+    std::vector<std::pair<uint64_t,uint32_t>>  grid;
+    std::unordered_map<const Npc*,uint32_t>    slot;
+    std::unordered_map<uint64_t,SensesBit>     senses;
+    std::vector<Candidate>                     candidates;
+    std::vector<std::vector<uint32_t>>         inboxes;
+    std::unordered_set<Delivery,DeliveryHash>  delivered;
+    Stats                                      st;
+  };
@@ -442,16 +442,22 @@ const Tempest::Vec3* Interactive::bBox() const {
 
 bool Interactive::setMobState(std::string_view scheme, int32_t st) {
   const bool ret = Vob::setMobState(scheme,st);
+  if(state==st)
+    return true;
+  return applyMobState(scheme,st) && ret;
+  }
+
+bool Interactive::applyMobState(std::string_view scheme, int32_t st) {
   if(state==st)
     return true;
 
   if(schemeName()!=scheme)
-    return ret;
+    return true;
 
   string_frm name("S_S",st);
   if(visual.startAnimAndGet(name,world.tickCount())!=nullptr || !visual.isAnimExist(name)) {
     setState(st);
-    return ret;
+    return true;
     }
   return false;
   }
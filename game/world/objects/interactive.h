@@ -52,6 +52,7 @@ class Interactive : public Vob {
     int32_t             stateId() const { return state; }
     int32_t             stateCount() const { return stateNum; }
     bool                setMobState(std::string_view scheme,int32_t st) override;
+    bool                applyMobState(std::string_view scheme,int32_t st);
     void                emitTriggerEvent(TriggerEvent::Type type) const;
     void                emitSoundEffect(std::string_view sound, float range, bool freeSlot);
     std::string_view    schemeName() const;
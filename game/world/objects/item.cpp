@@ -108,6 +108,7 @@ bool Item::isTorchBurn() const {
 
 void Item::setPosition(float x, float y, float z) {
   pos={x,y,z};
+  lerpTick = uint64_t(-1);
   updateMatrix();
   }
 
@@ -115,6 +116,11 @@ void Item::setDirection(float, float, float) {
   }
 
 void Item::setObjMatrix(const Tempest::Matrix4x4 &m) {
+  const uint64_t now = world.tickCount();
+  if(lerpTick!=now) {
+    lerpPrev = pos;
+    lerpTick = now;
+    }
   pos.x = m.at(3,0);
   pos.y = m.at(3,1);
   pos.z = m.at(3,2);
@@ -122,6 +128,25 @@ void Item::setObjMatrix(const Tempest::Matrix4x4 &m) {
   view.setObjMatrix(m);
   }
 
+void Item::updateLerp(float alpha) {
+  if(lerpTick==uint64_t(-1))
+    return;
+  if(lerpTick!=world.tickCount()) {
+    // not moved by last step anymore - settle on actual position
+    lerpTick = uint64_t(-1);
+    view.setObjMatrix(transform());
+    return;
+    }
+  if((pos-lerpPrev).quadLength()>=MaxLerpDist*MaxLerpDist)
+    return;
+  const Tempest::Vec3 at = lerpPrev + (pos-lerpPrev)*alpha;
+  auto m = transform();
+  m.set(3,0,at.x);
+  m.set(3,1,at.y);
+  m.set(3,2,at.z);
+  view.setObjMatrix(m);
+  }
+
 bool Item::isMission() const {
   return (uint32_t(hitem->flags)&ITM_MISSION);
   }
@@ -35,6 +35,7 @@ class Item : public Vob {
     void    setPosition  (float x,float y,float z);
     void    setDirection (float x,float y,float z);
     void    setObjMatrix (const Tempest::Matrix4x4& m);
+    void    updateLerp   (float alpha);
 
     bool    isMission() const;
     bool    isEquipped() const { return equipped>0; }
@@ -93,8 +94,13 @@ class Item : public Vob {
   private:
     void                updateMatrix();
 
+    // physics moves items in fixed steps; visual is interpolated from previous step
+    static constexpr float         MaxLerpDist = 200.f;
+
     std::shared_ptr<zenkit::IItem> hitem={};
     Tempest::Vec3                  pos={};
+    Tempest::Vec3                  lerpPrev={};
+    uint64_t                       lerpTick=uint64_t(-1);
 
     uint32_t                       amount   = 0;
     uint8_t                        equipped = 0;
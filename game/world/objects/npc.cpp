@@ -1964,46 +1964,14 @@ Npc *Npc::updateNearestEnemy() {
   if(aiPolicy!=ProcessPolicy::AiNormal)
     return nullptr;
 
-  Npc*  ret  = nullptr;
-  float dist = std::numeric_limits<float>::max();
-  if(nearestEnemy!=nullptr &&
-     (!nearestEnemy->isDown() && canSenseNpc(*nearestEnemy,true)!=SensesBit::SENSE_NONE)) {
-    ret  = nearestEnemy;
-    dist = qDistTo(*ret);
-    }
-
-  owner.detectNpcNear([this,&ret,&dist](Npc& n){
-    if(!isEnemy(n) || n.isDown() || &n==this)
-      return;
-
-    float d = qDistTo(n);
-    if(d<dist && canSenseNpc(n,true)!=SensesBit::SENSE_NONE) {
-      ret  = &n;
-      dist = d;
-      }
-    });
-  nearestEnemy = ret;
+  nearestEnemy = owner.perception().nearestEnemy(*this,nearestEnemy);
   return nearestEnemy;
   }
 
 Npc* Npc::updateNearestBody() {
   if(aiPolicy!=ProcessPolicy::AiNormal)
     return nullptr;
-
-  Npc*  ret  = nullptr;
-  float dist = std::numeric_limits<float>::max();
-
-  owner.detectNpcNear([this,&ret,&dist](Npc& n){
-    if(!n.isDead())
-      return;
-
-    float d = qDistTo(n);
-    if(d<dist && canSenseNpc(n,true)!=SensesBit::SENSE_NONE) {
-      ret  = &n;
-      dist = d;
-      }
-    });
-  return ret;
+  return owner.perception().nearestBody(*this);
   }
 
 void Npc::tickTimedEvt(Animation::EvCount& ev) {
@@ -2136,6 +2104,7 @@ void Npc::tickAnimationTags() {
 void Npc::tick(uint64_t dt) {
   static bool dbg = false;
   static int  kId = -1;
+  tickPrevPos = Vec3(x,y,z);
   if(dbg && !isPlayer() && hnpc->id!=kId)
     return;
 
@@ -2196,6 +2165,95 @@ void Npc::tick(uint64_t dt) {
   implAiTick(dt);
   }
 
+bool Npc::tickCoarse(uint64_t dt) {
+  if(!canTickCoarse()) {
+    coarse = false;
+    return false;
+    }
+  if(!coarse) {
+    coarse       = true;
+    coarseDt     = uint64_t(uint32_t(hnpc->id))%CoarseStep; // spread far npc's across frames
+    coarseAnimDt = 0;
+    coarseWalk   = 0;
+    }
+  coarseDt += dt;
+  if(coarseDt<CoarseStep)
+    return true;
+  dt       = coarseDt;
+  coarseDt = 0;
+  implTickCoarse(dt);
+  return true;
+  }
+
+uint64_t Npc::coarseAnimStep(uint64_t dt) {
+  if(!coarse)
+    return dt;
+  coarseAnimDt += dt;
+  if(coarseAnimDt<CoarseStep)
+    return 0;
+  dt           = coarseAnimDt;
+  coarseAnimDt = 0;
+  return dt;
+  }
+
+bool Npc::canTickCoarse() const {
+  // anything, that needs physics or precise animation, goes through full tick
+  if(aiPolicy!=ProcessPolicy::AiFar2)
+    return false;
+  if(currentTarget!=nullptr || currentInteract!=nullptr || castLevel!=CS_NoCast || isInAir() || isDive())
+    return false;
+  if(aiQueueOverlay.size()>0)
+    return false;
+  return go2.flag==GT_No || go2.flag==GT_Way || go2.flag==GT_Point;
+  }
+
+void Npc::implTickCoarse(uint64_t dt) {
+  tickPrevPos = Vec3(x,y,z);
+
+  if(!isDead()) {
+    tickRegen(hnpc->attribute[ATR_HITPOINTS],hnpc->attribute[ATR_HITPOINTSMAX],
+              hnpc->attribute[ATR_REGENERATEHP],dt);
+    tickRegen(hnpc->attribute[ATR_MANA],hnpc->attribute[ATR_MANAMAX],
+              hnpc->attribute[ATR_REGENERATEMANA],dt);
+    }
+
+  if(waitTime>=owner.tickCount() || aniWaitTime>=owner.tickCount() || outWaitTime>owner.tickCount())
+    return;
+
+  if(!isDown() && implGoToCoarse(dt))
+    return;
+  implAiTick(dt);
+  }
+
+bool Npc::implGoToCoarse(uint64_t dt) {
+  if(go2.flag!=GT_Way && go2.flag!=GT_Point) {
+    coarseWalk = 0;
+    return false;
+    }
+
+  // teleport-like: jump to next point, once npc had enough time to walk there
+  coarseWalk += float(dt)*CoarseWalkSpeed;
+  while(!go2.empty()) {
+    auto  dest = go2.target();
+    float len  = (dest-position()).length();
+    if(len>coarseWalk)
+      return true;
+    coarseWalk -= len;
+    setPosition(dest);
+
+    if(go2.flag==GT_Way) {
+      go2.wp = wayPath.pop();
+      if(go2.wp!=nullptr) {
+        attachToPoint(go2.wp);
+        continue;
+        }
+      }
+    coarseWalk = 0;
+    clearGoTo();
+    }
+  return false;
+  }
+
 bool Npc::prepareTurn() {
   const auto st = bodyStateMasked();
   if(interactive()==nullptr && (st==BS_WALK || st==BS_SNEAK)) {
@@ -3950,7 +4008,7 @@ bool Npc::perceptionProcess(Npc &pl) {
     }
 
   const float quadDist = pl.qDistTo(*this);
-  if(hasPerc(PERC_ASSESSPLAYER) && canSenseNpc(pl,false)!=SensesBit::SENSE_NONE) {
+  if(hasPerc(PERC_ASSESSPLAYER) && owner.perception().senseNpc(*this,pl,false)!=SensesBit::SENSE_NONE) {
     if(perceptionProcess(pl,nullptr,quadDist,PERC_ASSESSPLAYER)) {
       ret = true;
       }
@@ -4472,7 +4530,13 @@ void Npc::updateAnimation(uint64_t dt) {
   if(isPlayer() && camera!=nullptr && camera->isFree())
     dt = 0;
 
-  if(durtyTranform) {
+  // with fixed-step simulation, visual position is interpolated in between of two last ticks
+  // coarse npc's move once per CoarseStep, not per tick - tickAlpha doesn't apply to them
+  const float alpha = owner.tickAlpha();
+  const Vec3  cur   = Vec3(x,y,z);
+  const bool  lerp  = !coarse && alpha<1.f && tickPrevPos!=cur && (cur-tickPrevPos).quadLength()<MaxLerpDist*MaxLerpDist;
+
+  if(durtyTranform || lerp || lerpTranform) {
     const auto ground = groundNormal();
     if(lastGroundNormal!=ground) {
       durtyTranform |= TR_Rot;
@@ -4480,15 +4544,11 @@ void Npc::updateAnimation(uint64_t dt) {
       }
 
     sfxWeapon.setPosition(x,y,z);
-    Matrix4x4 pos;
-    if(durtyTranform==TR_Pos) {
-      pos = visual.transform();
-      pos.set(3,0,x);
-      pos.set(3,1,y);
-      pos.set(3,2,z);
-      } else {
-      pos = mkPositionMatrix();
-      }
+    const Vec3 at = lerp ? (tickPrevPos + (cur-tickPrevPos)*alpha) : cur;
+    Matrix4x4  pos = (durtyTranform & ~TR_Pos)==0 ? visual.transform() : mkPositionMatrix();
+    pos.set(3,0,at.x);
+    pos.set(3,1,at.y);
+    pos.set(3,2,at.z);
 
     if(mvAlgo.isSwim()) {
       float chest = mvAlgo.canFlyOverWater() ? 0 : (translateY()-visual.pose().rootNode().at(3,1));
@@ -4498,6 +4558,7 @@ void Npc::updateAnimation(uint64_t dt) {
 
     visual.setObjMatrix(pos,false);
     durtyTranform = 0;
+    lerpTranform  = lerp;
     }
 
   bool syncAtt = visual.updateAnimation(this,nullptr,owner,dt);
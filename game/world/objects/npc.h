@@ -112,6 +112,9 @@ class Npc final {
     void       setWalkMode(WalkBit m);
     auto       walkMode() const { return wlkMode; }
     void       tick(uint64_t dt);
+    bool       tickCoarse(uint64_t dt);
+    auto       coarseAnimStep(uint64_t dt) -> uint64_t;
+    bool       isCoarse() const { return coarse; }
     void       tickAnimationTags();
     bool       startClimb(JumpStatus jump);
 
@@ -423,6 +426,13 @@ class Npc final {
       TR_Scale=1<<2,
       };
 
+    // teleport-like moves are not interpolated
+    static constexpr float MaxLerpDist = 200.f;
+
+    // coarse simulation of far-away npc's: time step and walking speed (units per ms) for waypoint advancement
+    static constexpr uint64_t CoarseStep      = 250;
+    static constexpr float    CoarseWalkSpeed = 0.2f;
+
     struct AiState final {
       ScriptFn funcIni;
       ScriptFn funcLoop;
@@ -462,6 +472,9 @@ class Npc final {
     void      tickRegen(int32_t& v,const int32_t max,const int32_t chg, const uint64_t dt);
     void      setViewPosition(const Tempest::Vec3& pos);
     bool      tickCast(uint64_t dt);
+    bool      canTickCoarse() const;
+    void      implTickCoarse(uint64_t dt);
+    bool      implGoToCoarse(uint64_t dt);
 
     int       aiOutputOrderId() const;
     bool      performOutput(const AiQueue::AiAction &ai);
@@ -540,7 +553,9 @@ class Npc final {
 
     // visual props (cache)
     uint8_t                        durtyTranform=0;
+    bool                           lerpTranform=false;
     Tempest::Vec3                  lastGroundNormal;
+    Tempest::Vec3                  tickPrevPos;
 
     DynamicWorld::NpcItem          physic;
 
@@ -594,6 +609,11 @@ class Npc final {
     AiQueue                        aiQueueOverlay;
     std::vector<Routine>           routines;
 
+    bool                           coarse       = false;
+    uint64_t                       coarseDt     = 0;
+    uint64_t                       coarseAnimDt = 0;
+    float                          coarseWalk   = 0;
+
     Interactive*                   currentInteract=nullptr;
     Npc*                           currentOther   =nullptr;
     Npc*                           currentVictim  =nullptr;
@@ -20,21 +20,19 @@ PfxEmitter::PfxEmitter(World& world, std::string_view name)
   :PfxEmitter(world,Gothic::inst().loadParticleFx(name)) {
   }
 
-PfxEmitter::PfxEmitter(World& world, const ParticleFx* decl)
-  :PfxEmitter(world.view()->pfxGroup,decl) {
+PfxEmitter::PfxEmitter(World& world, const ParticleFx* decl) {
+  if(world.view()==nullptr)
+    return; // headless simulation
+  implInit(world.view()->pfxGroup,decl);
   }
 
 PfxEmitter::PfxEmitter(PfxObjects& owner, const ParticleFx* decl) {
-  if(decl==nullptr || (decl->visMaterial.tex==nullptr && !decl->hasTrails()))
-    return;
-  std::lock_guard<std::recursive_mutex> guard(owner.sync);
-  bucket = &owner.getBucket(*decl);
-  id     = bucket->allocEmitter();
-  if(decl->shpMesh!=nullptr && decl->shpMeshRender)
-    shpMesh = owner.world.addView(decl->shpMesh_S,0,0,0);
+  implInit(owner,decl);
   }
 
 PfxEmitter::PfxEmitter(World& world, const zenkit::VirtualObject& vob) {
+  if(world.view()==nullptr)
+    return; // headless simulation
   auto& owner = world.view()->pfxGroup;
   if(FileExt::hasExt(vob.visual->name,"PFX")) {
     auto decl = Gothic::inst().loadParticleFx(vob.visual->name);
@@ -52,6 +50,16 @@ PfxEmitter::PfxEmitter(World& world, const zenkit::VirtualObject& vob) {
     }
   }
 
+void PfxEmitter::implInit(PfxObjects& owner, const ParticleFx* decl) {
+  if(decl==nullptr || (decl->visMaterial.tex==nullptr && !decl->hasTrails()))
+    return;
+  std::lock_guard<std::recursive_mutex> guard(owner.sync);
+  bucket = &owner.getBucket(*decl);
+  id     = bucket->allocEmitter();
+  if(decl->shpMesh!=nullptr && decl->shpMeshRender)
+    shpMesh = owner.world.addView(decl->shpMesh_S,0,0,0);
+  }
+
 PfxEmitter::~PfxEmitter() {
   if(bucket!=nullptr) {
     std::lock_guard<std::recursive_mutex> guard(bucket->parent.sync);
@@ -146,6 +154,8 @@ void PfxEmitter::setLooped(bool loop) {
   }
 
 void PfxEmitter::setMesh(const MeshObjects::Mesh* mesh, const Pose* pose) {
+  if(bucket==nullptr)
+    return;
   const PfxEmitterMesh* m = (mesh!=nullptr) ? mesh->toMeshEmitter() : nullptr;
 
   std::lock_guard<std::recursive_mutex> guard(bucket->parent.sync);
@@ -157,6 +167,8 @@ void PfxEmitter::setMesh(const MeshObjects::Mesh* mesh, const Pose* pose) {
   }
 
 void PfxEmitter::setPhysicsEnable(World& p, std::function<void (Npc&)> cb) {
+  if(bucket==nullptr)
+    return;
   std::lock_guard<std::recursive_mutex> guard(bucket->parent.sync);
   auto& v = bucket->get(id);
   zone = CollisionZone(p, v.pos, bucket->decl);
@@ -13,6 +13,12 @@ StaticObj::StaticObj(Vob* parent, World& world, const zenkit::VirtualObject& vob
   visual.setObjMatrix(transform());
 
   scheme = vob.visual->name;
+  world.addStatic(this);
+  }
+
+StaticObj::~StaticObj() {
+  // vob-bundles (fireplaces, item effects) are destroyed at runtime
+  world.removeStatic(this);
   }
 
 void StaticObj::moveEvent() {
@@ -22,13 +28,16 @@ void StaticObj::moveEvent() {
 
 bool StaticObj::setMobState(std::string_view sc, int32_t st) {
   const bool ret = Vob::setMobState(sc,st);
+  return applyMobState(sc,st) && ret;
+  }
 
+bool StaticObj::applyMobState(std::string_view sc, int32_t st) {
   if(scheme.find(sc)!=0)
-    return ret;
+    return true;
   string_frm name("S_S",st);
   if(visual.startAnimAndGet(name,world.tickCount())!=nullptr) {
     // state = st;
-    return ret;
+    return true;
     }
   return false;
   }
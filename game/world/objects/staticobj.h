@@ -6,6 +6,10 @@
 class StaticObj : public Vob {
   public:
     StaticObj(Vob* parent, World& world, const zenkit::VirtualObject& vob, Flags flags);
+    ~StaticObj();
+
+    std::string_view schemeName() const { return scheme; }
+    bool             applyMobState(std::string_view scheme,int32_t st);
 
   private:
     void  moveEvent() override;
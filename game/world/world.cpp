@@ -21,6 +21,7 @@
 #include "gothic.h"
 #include "focus.h"
 #include "resources.h"
+#include "utils/profiler.h"
 
 const char* materialTag(ItemMaterial src) {
   switch(src) {
@@ -86,6 +87,8 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
       return std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh));
       });
     auto wviewFut = std::async(std::launch::async, [&]() {
+      if(Resources::isHeadless())
+        return std::unique_ptr<WorldView>(); // simulation only, nothing to draw
       Workers::setThreadName("Loading: PackedMesh thread");
       PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd);
       return std::unique_ptr<WorldView>(new WorldView(*this,vmesh));
@@ -253,38 +256,56 @@ MeshObjects::Mesh World::addView(std::string_view visual) const {
   }
 
 MeshObjects::Mesh World::addView(std::string_view visual, int32_t headTex, int32_t teetTex, int32_t bodyColor) const {
+  if(wview==nullptr)
+    return MeshObjects::Mesh();
   return view()->addView(visual,headTex,teetTex,bodyColor);
   }
 
 MeshObjects::Mesh World::addView(const zenkit::IItem& itm) {
+  if(wview==nullptr)
+    return MeshObjects::Mesh();
   return view()->addView(itm.visual,itm.material,0,itm.material);
   }
 
 MeshObjects::Mesh World::addView(const ProtoMesh* visual) {
+  if(wview==nullptr)
+    return MeshObjects::Mesh();
   return view()->addView(visual);
   }
 
 MeshObjects::Mesh World::addAtachView(const ProtoMesh::Attach& visual, const int32_t version) {
+  if(wview==nullptr)
+    return MeshObjects::Mesh();
   return view()->addAtachView(visual,version);
   }
 
 MeshObjects::Mesh World::addStaticView(const ProtoMesh* visual, bool staticDraw) {
+  if(wview==nullptr)
+    return MeshObjects::Mesh();
   return view()->addStaticView(visual,staticDraw);
   }
 
 MeshObjects::Mesh World::addStaticView(std::string_view visual) {
+  if(wview==nullptr)
+    return MeshObjects::Mesh();
   return view()->addStaticView(visual);
   }
 
 MeshObjects::Mesh World::addDecalView(const zenkit::VisualDecal& decal) {
+  if(wview==nullptr)
+    return MeshObjects::Mesh();
   return view()->addDecalView(decal);
   }
 
 LightGroup::Light World::addLight(const zenkit::VLight& vob) {
+  if(wview==nullptr)
+    return LightGroup::Light();
   return view()->addLight(vob);
   }
 
 LightGroup::Light World::addLight(std::string_view preset) {
+  if(wview==nullptr)
+    return LightGroup::Light();
   return view()->addLight(preset);
   }
 
@@ -373,12 +394,14 @@ void World::scaleTime(uint64_t& dt) {
   }
 
 void World::tick(uint64_t dt) {
+  PROFILE_SCOPE("World::tick");
   static bool doTicks=true;
   if(!doTicks)
     return;
   wobj.tick(dt,dt);
   wdynamic->tick(dt);
-  wview->tick(dt);
+  if(wview!=nullptr)
+    wview->tick(dt);
   if(auto pl = player())
     wsound.tick(*pl);
   globFx->tick(dt);
@@ -388,6 +411,14 @@ uint64_t World::tickCount() const {
   return game.tickCount();
   }
 
+uint64_t World::renderTickCount() const {
+  return game.renderTickCount();
+  }
+
+float World::tickAlpha() const {
+  return game.tickAlpha();
+  }
+
 void World::setDayTime(int32_t h, int32_t min) {
   gtime now     = game.time();
   auto  day     = now.day();
@@ -793,6 +824,8 @@ bool World::isInSfxRange(const Tempest::Vec3& pos) const {
   }
 
 bool World::isInPfxRange(const Tempest::Vec3& p) const {
+  if(wview==nullptr)
+    return false;
   return wview->isInPfxRange(p);
   }
 
@@ -809,6 +842,14 @@ void World::addInteractive(Interactive* inter) {
   wobj.addInteractive(inter);
   }
 
+void World::addStatic(StaticObj* obj) {
+  wobj.addStatic(obj);
+  }
+
+void World::removeStatic(StaticObj* obj) {
+  wobj.removeStatic(obj);
+  }
+
 void World::addStartPoint(const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name) {
   wmatrix->addStartPoint(pos,dir,name);
   }
@@ -962,8 +1003,12 @@ const WayPoint& World::deadPoint() const {
   return wmatrix->deadPoint();
   }
 
-void World::detectNpcNear(std::function<void (Npc &)> f) {
-  wobj.detectNpcNear(f);
+NpcPerception& World::perception() {
+  return wobj.perception();
+  }
+
+const WorldObjects::TierStats& World::tierStats() const {
+  return wobj.tierStats();
   }
 
 void World::detectNpc(const Tempest::Vec3& p, const float r, const std::function<void(Npc&)>& f) {
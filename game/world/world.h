@@ -25,6 +25,7 @@ class VisualFx;
 class GlobalEffects;
 class ParticleFx;
 class Interactive;
+class StaticObj;
 class VersionInfo;
 class GlobalFx;
 
@@ -69,7 +70,8 @@ class World final {
     const WayPoint&      startPoint() const;
     const WayPoint&      deadPoint() const;
 
-    void                 detectNpcNear(std::function<void(Npc&)> f);
+    NpcPerception&       perception();
+    auto                 tierStats() const -> const WorldObjects::TierStats&;
     void                 detectNpc (const Tempest::Vec3& p, const float r, const std::function<void(Npc&)>& f);
     void                 detectItem(const Tempest::Vec3& p, const float r, const std::function<void(Item&)>& f);
 
@@ -115,6 +117,8 @@ class World final {
     void                 scaleTime(uint64_t& dt);
     void                 tick(uint64_t dt);
     uint64_t             tickCount() const;
+    uint64_t             renderTickCount() const;
+    float                tickAlpha() const;
     void                 setDayTime(int32_t h,int32_t min);
     gtime                time() const;
 
@@ -184,6 +188,8 @@ class World final {
 
     void                 addTrigger    (AbstractTrigger* trigger);
     void                 addInteractive(Interactive* inter);
+    void                 addStatic     (StaticObj* obj);
+    void                 removeStatic  (StaticObj* obj);
     void                 addStartPoint (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
     void                 addFreePoint  (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
     void                 addSound      (const zenkit::VirtualObject& vob);
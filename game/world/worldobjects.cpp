@@ -5,6 +5,7 @@
 #include "world/objects/item.h"
 #include "world/objects/npc.h"
 #include "world/objects/interactive.h"
+#include "world/objects/staticobj.h"
 #include "world/objects/vob.h"
 #include "world/collisionzone.h"
 #include "world/triggers/cscamera.h"
@@ -14,12 +15,17 @@
 #include "world.h"
 #include "utils/workers.h"
 #include "utils/dbgpainter.h"
+#include "utils/profiler.h"
+#include "commandline.h"
 #include "gothic.h"
 
 #include <Tempest/Painter>
 #include <Tempest/Application>
 #include <Tempest/Log>
 
+#include <algorithm>
+#include <chrono>
+
 using namespace Tempest;
 
 int32_t WorldObjects::MobStates::stateByTime(gtime t) const {
@@ -35,6 +41,24 @@ int32_t WorldObjects::MobStates::stateByTime(gtime t) const {
   return 0;
   }
 
+gtime WorldObjects::MobStates::nextBoundary(gtime t) const {
+  // routines are sorted by time of day
+  const auto day = t.day();
+  const auto tm  = t.timeInDay();
+  for(auto& i:routines) {
+    if(tm<i.time) {
+      gtime ret(day,0,0);
+      ret.addMilis(uint64_t(i.time.toInt()));
+      return ret;
+      }
+    }
+  if(routines.empty())
+    return gtime::endOfTime();
+  gtime ret(day+1,0,0);
+  ret.addMilis(uint64_t(routines.front().time.toInt()));
+  return ret;
+  }
+
 void WorldObjects::MobStates::save(Serialize& fout) {
   fout.write(curState,scheme);
   fout.write(uint32_t(routines.size()));
@@ -104,6 +128,7 @@ void WorldObjects::load(Serialize &fin) {
   routines.resize(sz);
   for(auto& i:routines)
     i.load(fin);
+  mobWakeDirty = true;
 
   for(auto& i:interactiveObj)
     i->postValidate();
@@ -141,6 +166,7 @@ void WorldObjects::save(Serialize &fout) {
   }
 
 void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
+  PROFILE_SCOPE("WorldObjects::tick");
   auto passive=std::move(sndPerc);
   sndPerc.clear();
 
@@ -163,22 +189,30 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   auto       camera  = Gothic::inst().camera();
   const bool freeCam = (camera!=nullptr && camera->isFree());
   const auto pl      = owner.player();
+  // per-tier timing costs two clock reads per npc - only when someone is looking at it
+  const bool timed   = Profiler::isEnabled() || CommandLine::inst().simBenchmarkHours()>0;
   for(size_t i=0; i<npcArr.size(); ++i) {
     auto& npc = *npcArr[i];
     uint64_t d = (pl==&npc ? dtPlayer : dt);
     if(freeCam && pl==&npc)
       continue;
-    npc.tick(d);
-    }
 
-  for(auto& i:routines) {
-    auto s = i.stateByTime(owner.time());
-    if(s!=i.curState) {
-      setMobState(i.scheme,s);
-      i.curState = s;
+    std::chrono::steady_clock::time_point t0;
+    if(timed)
+      t0 = std::chrono::steady_clock::now();
+    auto tier = TierStats::Tier(npc.processPolicy());
+    if(npc.tickCoarse(d))
+      tier = TierStats::AiFar2Coarse; else
+      npc.tick(d);
+    tierSt.ticks[tier] += 1;
+    if(timed) {
+      const auto t1 = std::chrono::steady_clock::now();
+      tierSt.timeNs[tier] += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t1-t0).count());
       }
     }
 
+  tickMobRoutines();
+
   for(CollisionZone* z:collisionZn)
     z->tick(dt);
 
@@ -230,6 +264,14 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   if(pl==nullptr)
     return;
 
+  PROFILE_SCOPE("WorldObjects::perception");
+  npcPerc.begin();
+  for(size_t i=0; i<passive.size(); ++i) {
+    auto&       m     = passive[i];
+    const float range = float(owner.script().percRanges().at(PercType(m.what), int(npcPerc.maxSensesRange())));
+    npcPerc.dispatch(uint32_t(i), m, range);
+    }
+
   for(auto& ptr:npcNear) {
     Npc& i = *ptr;
     if(i.isPlayer() || i.isDead())
@@ -241,10 +283,11 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
       }
 
     if(i.processPolicy()==Npc::AiNormal) {
-      for(auto& r:passive)
-        passivePerceptionProcess(r, *ptr, *pl);
+      for(auto id:npcPerc.inbox(i))
+        passivePerceptionProcess(passive[id], *ptr, *pl);
       }
     }
+  npcPerc.end();
   }
 
 uint32_t WorldObjects::npcId(const Npc *ptr) const {
@@ -390,49 +433,58 @@ void WorldObjects::triggerEvent(const TriggerEvent &e) {
 void WorldObjects::tickTriggers(uint64_t /*dt*/) {
   execDelayedEvents();
 
-  auto evt = std::move(triggerEvents);
-  triggerEvents.clear();
-
-  for(auto& e:evt)
+  // events, emitted while processing, go to the next tick
+  std::swap(triggerEvents,triggerEventsExec);
+  for(auto& e:triggerEventsExec)
     owner.execTriggerEvent(e);
+  triggerEventsExec.clear();
   }
 
 void WorldObjects::execDelayedEvents() {
-  auto def = std::move(triggersDef);
-  triggersDef.clear();
-  for(auto i:def) {
+  std::swap(triggersDef,triggersDefExec);
+  for(auto i:triggersDefExec) {
     i->processDelayedEvents();
     if(i->hasDelayedEvents())
       triggersDef.push_back(i);
     }
+  triggersDefExec.clear();
   }
 
 bool WorldObjects::execTriggerEvent(const TriggerEvent& e) {
-  bool emitted=false;
-
-  for(auto& i:triggers) {
-    auto& t = *i;
-    if(t.name()!=e.target)
-      continue; // NOTE: trigger name is not unique - more then one trigger can be activated
-    t.processEvent(e);
-    emitted = true;
-    }
+  auto it = triggerByName.find(e.target);
+  if(it==triggerByName.end())
+    return false;
 
-  return emitted;
+  // NOTE: trigger name is not unique - more then one trigger can be activated
+  // index-loop: processEvent may spawn new triggers with same name
+  auto& list = it->second;
+  for(size_t i=0; i<list.size(); ++i)
+    list[i]->processEvent(e);
+  return !list.empty();
   }
 
 void WorldObjects::updateAnimation(uint64_t dt) {
+  PROFILE_SCOPE("WorldObjects::updateAnimation");
   static bool doAnim=true;
   if(!doAnim)
     return;
   if(dt==0)
     return;
   Workers::parallelTasks(npcArr,[dt](std::unique_ptr<Npc>& i){
-    i->updateAnimation(dt);
+    // coarse npc's accumulate time and are animated in bigger steps
+    if(auto d = i->coarseAnimStep(dt))
+      i->updateAnimation(d);
     });
   interactiveObj.parallelFor([dt](Interactive& i){
     i.updateAnimation(dt);
     });
+
+  // physics driven objects: interpolate in between of two last simulation steps
+  const float alpha = owner.tickAlpha();
+  for(auto& i:bullets)
+    i.updateLerp(alpha);
+  for(auto& i:itemArr)
+    i->updateLerp(alpha);
   }
 
 bool WorldObjects::isTargeted(Npc& dst) {
@@ -484,11 +536,6 @@ Item* WorldObjects::findItemByInstance(size_t instance, size_t n) {
   return nullptr;
   }
 
-void WorldObjects::detectNpcNear(const std::function<void(Npc&)>& f) {
-  for(auto& i:npcNear)
-    f(*i);
-  }
-
 void WorldObjects::detectNpc(const float x, const float y, const float z,
                              const float r, const std::function<void(Npc&)>& f) {
   float maxDist=r*r;
@@ -511,6 +558,7 @@ void WorldObjects::detectItem(const float x, const float y, const float z,
 
 void WorldObjects::addTrigger(AbstractTrigger* tg) {
   triggers.emplace_back(tg);
+  triggerByName[tg->name()].push_back(tg);
   }
 
 void WorldObjects::enableDefTrigger(AbstractTrigger& t) {
@@ -700,10 +748,20 @@ Item* WorldObjects::addItemDyn(size_t itemInstance, const Tempest::Matrix4x4& po
 
 void WorldObjects::addInteractive(Interactive* obj) {
   interactiveObj.add(obj);
+  mobSchemeDirty = true;
   }
 
 void WorldObjects::addStatic(StaticObj* obj) {
   objStatic.push_back(obj);
+  mobSchemeDirty = true;
+  }
+
+void WorldObjects::removeStatic(StaticObj* obj) {
+  auto it = std::find(objStatic.begin(),objStatic.end(),obj);
+  if(it==objStatic.end())
+    return;
+  objStatic.erase(it);
+  mobSchemeDirty = true;
   }
 
 void WorldObjects::addRoot(const std::shared_ptr<zenkit::VirtualObject>& vob, bool startup) {
@@ -868,6 +926,7 @@ void WorldObjects::setMobRoutine(gtime time, std::string_view scheme, int32_t st
       std::sort(i.routines.begin(),i.routines.end(),[](const MobRoutine& l, const MobRoutine& r){
         return l.time<r.time;
         });
+      mobWakeDirty = true;
       return;
       }
     }
@@ -875,6 +934,7 @@ void WorldObjects::setMobRoutine(gtime time, std::string_view scheme, int32_t st
   st.scheme = scheme;
   st.routines.push_back(r);
   routines.emplace_back(std::move(st));
+  mobWakeDirty = true;
   }
 
 void WorldObjects::sendPassivePerc(Npc &self, Npc &other, Npc* victim, Item* itm, int32_t perc) {
@@ -975,6 +1035,7 @@ void WorldObjects::resetPositionToTA() {
     auto s = i.stateByTime(owner.time());
     i.curState = s;
     }
+  mobWakeDirty = true;
   for(auto& i:interactiveObj) {
     int32_t state = -1;
     for(auto& r:routines) {
@@ -986,8 +1047,78 @@ void WorldObjects::resetPositionToTA() {
   }
 
 void WorldObjects::setMobState(std::string_view scheme, int32_t st) {
-  for(auto& i:rootVobs)
-    i->setMobState(scheme,st);
+  if(mobSchemeDirty)
+    rebuildMobSchemes();
+
+  if(auto it = mobByScheme.find(scheme); it!=mobByScheme.end()) {
+    for(auto i:it->second)
+      i->applyMobState(scheme,st);
+    }
+
+  // static objects match by prefix: all candidates form a continuous range in sorted array
+  auto it = std::lower_bound(staticByScheme.begin(),staticByScheme.end(),scheme,[](const std::pair<std::string_view,StaticObj*>& a, std::string_view b){
+    return a.first<b;
+    });
+  for(; it!=staticByScheme.end() && it->first.substr(0,scheme.size())==scheme; ++it)
+    it->second->applyMobState(scheme,st);
+  }
+
+void WorldObjects::rebuildMobSchemes() {
+  mobSchemeDirty = false;
+
+  mobByScheme.clear();
+  for(auto i:interactiveObj)
+    mobByScheme[i->schemeName()].push_back(i);
+
+  staticByScheme.clear();
+  staticByScheme.reserve(objStatic.size());
+  for(auto i:objStatic)
+    staticByScheme.emplace_back(i->schemeName(),i);
+  std::stable_sort(staticByScheme.begin(),staticByScheme.end(),[](const std::pair<std::string_view,StaticObj*>& a, const std::pair<std::string_view,StaticObj*>& b){
+    return a.first<b.first;
+    });
+  }
+
+bool WorldObjects::wakeLater(const MobWake& a, const MobWake& b) {
+  return b.time<a.time;
+  }
+
+void WorldObjects::tickMobRoutines() {
+  const gtime now = owner.time();
+  if(mobWakeDirty || now<mobWakeTime)
+    rebuildMobWake();
+  mobWakeTime = now;
+
+  while(!mobWake.empty() && mobWake.front().time<=now) {
+    std::pop_heap(mobWake.begin(),mobWake.end(),wakeLater);
+    auto& w = mobWake.back();
+    auto& m = *w.mob;
+    auto  s = m.stateByTime(now);
+    if(s!=m.curState) {
+      setMobState(m.scheme,s);
+      m.curState = s;
+      }
+    w.time = m.nextBoundary(now);
+    std::push_heap(mobWake.begin(),mobWake.end(),wakeLater);
+    }
+  }
+
+void WorldObjects::rebuildMobWake() {
+  // bulk rebuild: after load, time jump or new routine
+  const gtime now = owner.time();
+  mobWake.clear();
+  for(auto& i:routines) {
+    if(i.routines.empty())
+      continue;
+    auto s = i.stateByTime(now);
+    if(s!=i.curState) {
+      setMobState(i.scheme,s);
+      i.curState = s;
+      }
+    mobWake.push_back(MobWake{i.nextBoundary(now),&i});
+    }
+  std::make_heap(mobWake.begin(),mobWake.end(),wakeLater);
+  mobWakeDirty = false;
   }
 
 template<class T>
@@ -2,11 +2,14 @@
 
 #include <vector>
 #include <memory>
+#include <string_view>
+#include <unordered_map>
 
 #include <zenkit/vobs/Misc.hh>
 
 #include "bullet.h"
 #include "spaceindex.h"
+#include "npcperception.h"
 #include "game/gametime.h"
 #include "game/perceptionmsg.h"
 #include "game/constants.h"
@@ -28,6 +31,20 @@ class WorldObjects final {
     WorldObjects(World &owner);
     ~WorldObjects();
 
+    // npc simulation cost, split by process policy; AiFar2 npc's on coarse step are accounted separately
+    struct TierStats {
+      enum Tier : uint8_t {
+        Player,
+        AiNormal,
+        AiFar,
+        AiFar2,
+        AiFar2Coarse,
+        Count,
+        };
+      uint64_t ticks [Count] = {};
+      uint64_t timeNs[Count] = {}; // only while profiler is enabled, or in simulation benchmark
+      };
+
     enum SearchFlg : uint8_t {
       NoFlg         = 0,
       NoDeath       = 1,
@@ -64,7 +81,8 @@ class WorldObjects final {
     Npc*           findHero();
     Npc*           findNpcByInstance(size_t instance, size_t n = 0);
     Item*          findItemByInstance(size_t instance, size_t n = 0);
-    void           detectNpcNear(const std::function<void(Npc&)>& f);
+    NpcPerception& perception() { return npcPerc; }
+    const TierStats& tierStats() const { return tierSt; }
     void           detectNpc (const float x, const float y, const float z, const float r, const std::function<void(Npc&)>&  f);
     void           detectItem(const float x, const float y, const float z, const float r, const std::function<void(Item&)>& f);
 
@@ -112,6 +130,7 @@ class WorldObjects final {
 
     void           addInteractive(Interactive*         obj);
     void           addStatic     (StaticObj*           obj);
+    void           removeStatic  (StaticObj*           obj);
     void           addRoot       (const std::shared_ptr<zenkit::VirtualObject>& vob, bool startup);
     void           invalidateVobIndex();
 
@@ -147,10 +166,17 @@ class WorldObjects final {
       std::vector<MobRoutine> routines;
       int32_t                 curState = 0;
       int32_t                 stateByTime(gtime t) const;
+      gtime                   nextBoundary(gtime t) const;
       void                    save(Serialize& fout);
       void                    load(Serialize& fin);
       };
 
+    // next routine boundary of a mob scheme; kept as min-heap, so schemes are touched only when their state changes
+    struct MobWake {
+      gtime      time;
+      MobStates* mob = nullptr;
+      };
+
     struct EffectState {
       Effect   eff;
       uint64_t timeUntil = 0;
@@ -159,14 +185,20 @@ class WorldObjects final {
     World&                             owner;
 
     std::vector<CollisionZone*>        collisionZn;
+    // static objects unregister on destruction - must outlive rootVobs
+    std::vector<StaticObj*>            objStatic;
+    bool                               mobSchemeDirty = true;
     std::vector<std::unique_ptr<Vob>>  rootVobs;
 
     SpaceIndex<Interactive>            interactiveObj;
     SpaceIndex<Item>                   items;
 
-    std::vector<StaticObj*>            objStatic;
     std::vector<std::unique_ptr<Item>> itemArr;
     std::list<MobStates>               routines;
+    std::vector<MobWake>               mobWake;
+    gtime                              mobWakeTime;
+    bool                               mobWakeDirty = true;
+    TierStats                          tierSt;
 
     std::list<Bullet>                  bullets;
     std::vector<EffectState>           effects;
@@ -175,12 +207,22 @@ class WorldObjects final {
     std::vector<std::unique_ptr<Npc>>  npcInvalid; // dead or invalid TA
     std::vector<std::unique_ptr<Npc>>  npcRemoved; // removed, but may have a dangling references in game
     std::vector<Npc*>                  npcNear;
+    NpcPerception                      npcPerc{npcNear};
 
     std::vector<AbstractTrigger*>      triggers;
     std::vector<AbstractTrigger*>      triggersTk;
     std::vector<AbstractTrigger*>      triggersDef;
+    std::vector<AbstractTrigger*>      triggersDefExec;
     std::vector<PerceptionMsg>         sndPerc;
     std::vector<TriggerEvent>          triggerEvents;
+    std::vector<TriggerEvent>          triggerEventsExec; // swapped with triggerEvents each tick, to keep both allocations
+
+    // trigger name is not unique - one event may activate several triggers; keys point to AbstractTrigger::name()
+    std::unordered_map<std::string_view,std::vector<AbstractTrigger*>> triggerByName;
+
+    // mob-state targets: interactives by exact scheme, static objects by scheme prefix (sorted)
+    std::unordered_map<std::string_view,std::vector<Interactive*>>      mobByScheme;
+    std::vector<std::pair<std::string_view,StaticObj*>>                 staticByScheme;
     CsCamera*                          currentCsCamera = nullptr;
 
     template<class T>
@@ -192,6 +234,10 @@ class WorldObjects final {
     bool testObj(T &src, const Npc &pl, const SearchOpt& opt, float& rlen);
 
     void             setMobState(std::string_view scheme, int32_t st);
+    void             rebuildMobSchemes();
+    void             tickMobRoutines();
+    void             rebuildMobWake();
+    static bool      wakeLater(const MobWake& a, const MobWake& b);
     void             passivePerceptionProcess(PerceptionMsg& msg, Npc& npc, Npc& pl);
 
     void             tickNear(uint64_t dt);
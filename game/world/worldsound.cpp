@@ -2,6 +2,9 @@
 
 #include <Tempest/SoundEffect>
 
+#include <algorithm>
+#include <cmath>
+
 #include "camera.h"
 #include "game/definitions/musicdefinitions.h"
 #include "game/gamesession.h"
@@ -10,13 +13,17 @@
 #include "world/objects/sound.h"
 #include "sound/soundfx.h"
 #include "utils/string_frm.h"
+#include "utils/workers.h"
 #include "world.h"
 #include "gamemusic.h"
 #include "gothic.h"
 #include "resources.h"
+#include "utils/profiler.h"
 
-const float WorldSound::maxDist   = 7000; // 70 meters
-const float WorldSound::talkRange = 2000;
+const float WorldSound::maxDist     = 7000; // 70 meters
+const float WorldSound::talkRange   = 2000;
+const float WorldSound::listenerPad = 800;
+const float WorldSound::gridSize    = 5000;
 
 struct WorldSound::WSound final {
   Sound          current;
@@ -109,6 +116,7 @@ void WorldSound::addSound(const zenkit::VSound &vob) {
     }
 
   worldEff.emplace_back(std::move(s));
+  worldEffIndexDurty = true;
   }
 
 Sound WorldSound::addDlgSound(std::string_view s, const Tempest::Vec3& pos, float range, uint64_t& timeLen) {
@@ -153,57 +161,120 @@ Sound WorldSound::implAddSound(Tempest::SoundEffect&& eff, const Tempest::Vec3&
   }
 
 void WorldSound::tick(Npc& player) {
-  std::lock_guard<std::mutex> guard(sync);
-
+  PROFILE_SCOPE("WorldSound::tick");
   auto cx = game.camera().listenerPosition();
+  game.updateListenerPos(cx);
+
+  {
+  std::lock_guard<std::mutex> guard(sync);
   plPos = cx.pos;
 
-  game.updateListenerPos(cx);
+  tickWorldEff();
+  occlusion.clear();
+  tickSlot(effect);
+  tickSlot(effect3d);
+  for(auto& i:freeSlot)
+    tickSlot(i.second);
+  }
 
-  for(auto& i:worldEff) {
-    if(!i.active || !i.current.isFinished())
-      continue;
-    if(i.current.isFinished())
-      i.current = Sound();
+  // ray-casts are most expensive part - do them without lock, on worker threads
+  if(!occlusion.empty()) {
+    auto dyn  = owner.physic();
+    auto head = plPos;
+    Workers::parallelFor(occlusion,[dyn,head](Occlusion& i){
+      i.occ = dyn->soundOclusion(head, i.eff->pos);
+      });
+    applyOcclusion();
+    }
 
-    if(i.restartTimeout>owner.tickCount() && !i.loop)
-      continue;
+  tickSoundZone(player);
+  }
 
-    if(!isInListenerRange(i.pos,i.sndRadius))
-      continue;
+void WorldSound::tickWorldEff() {
+  if(worldEffIndexDurty)
+    buildWorldEffIndex();
 
-    auto time = owner.time();
-    time = gtime(0,time.hour(),time.minute());
+  for(auto id:worldEffGlobal)
+    tickWorldEff(worldEff[id]);
 
-    const SoundFx* snd = nullptr;
-    if(i.sndStart<= time && time<i.sndEnd) {
-      snd = i.eff0;
-      } else {
-      snd = i.eff1;
-      }
+  const uint64_t key = gridKey(plPos.x,plPos.z);
+  auto l = std::lower_bound(worldEffIndex.begin(),worldEffIndex.end(),std::make_pair(key,uint32_t(0)));
+  for(; l!=worldEffIndex.end() && l->first==key; ++l)
+    tickWorldEff(worldEff[l->second]);
+  }
 
-    if(snd==nullptr)
-      continue;
+void WorldSound::tickWorldEff(WSound& i) {
+  if(!i.active || !i.current.isFinished())
+    return;
+  if(i.current.isFinished())
+    i.current = Sound();
 
-    i.current = implAddSound(*snd,i.pos,i.sndRadius);
-    if(!i.current.isEmpty()) {
-      effect.emplace_back(i.current.val);
-      i.current.play();
-      }
+  if(i.restartTimeout>owner.tickCount() && !i.loop)
+    return;
+
+  if(!isInListenerRange(i.pos,i.sndRadius))
+    return;
+
+  auto time = owner.time();
+  time = gtime(0,time.hour(),time.minute());
 
-    i.restartTimeout = owner.tickCount() + i.delay;
-    if(i.delayVar>0)
-      i.restartTimeout += uint64_t(std::rand())%i.delayVar;
+  const SoundFx* snd = nullptr;
+  if(i.sndStart<= time && time<i.sndEnd) {
+    snd = i.eff0;
+    } else {
+    snd = i.eff1;
+    }
+
+  if(snd==nullptr)
+    return;
 
-    if(!i.loop)
-      i.active = false;
+  i.current = implAddSound(*snd,i.pos,i.sndRadius);
+  if(!i.current.isEmpty()) {
+    effect.emplace_back(i.current.val);
+    i.current.play();
     }
 
-  tickSlot(effect);
-  tickSlot(effect3d);
-  for(auto& i:freeSlot)
-    tickSlot(*i.second);
-  tickSoundZone(player);
+  i.restartTimeout = owner.tickCount() + i.delay;
+  if(i.delayVar>0)
+    i.restartTimeout += uint64_t(std::rand())%i.delayVar;
+
+  if(!i.loop)
+    i.active = false;
+  }
+
+void WorldSound::buildWorldEffIndex() {
+  worldEffIndex.clear();
+  worldEffGlobal.clear();
+
+  for(uint32_t id=0; id<worldEff.size(); ++id) {
+    auto&   s  = worldEff[id];
+    float   r  = s.sndRadius+listenerPad;
+    int32_t x0 = gridCell(s.pos.x-r), x1 = gridCell(s.pos.x+r);
+    int32_t z0 = gridCell(s.pos.z-r), z1 = gridCell(s.pos.z+r);
+    if(int64_t(x1-x0+1)*int64_t(z1-z0+1) > 64) {
+      // huge radius - not worth to index
+      worldEffGlobal.push_back(id);
+      continue;
+      }
+    for(int32_t x=x0; x<=x1; ++x)
+      for(int32_t z=z0; z<=z1; ++z)
+        worldEffIndex.emplace_back(gridKey(x,z),id);
+    }
+
+  std::sort(worldEffIndex.begin(),worldEffIndex.end());
+  worldEffIndexDurty = false;
+  }
+
+int32_t WorldSound::gridCell(float v) {
+  return int32_t(std::floor(v/gridSize));
+  }
+
+uint64_t WorldSound::gridKey(int32_t x, int32_t z) {
+  return (uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z));
+  }
+
+uint64_t WorldSound::gridKey(float x, float z) {
+  return gridKey(gridCell(x),gridCell(z));
   }
 
 bool WorldSound::execTriggerEvent(const TriggerEvent& e) {
@@ -283,11 +354,12 @@ void WorldSound::tickSlot(std::vector<PEffect>& effect) {
       }
     }
   for(auto& i:effect) {
-    tickSlot(*i);
+    tickSlot(i);
     }
   }
 
-void WorldSound::tickSlot(Effect& slot) {
+void WorldSound::tickSlot(const PEffect& pslot) {
+  auto& slot = *pslot;
   if(slot.eff.isFinished()) {
     if(!slot.loop)
       return;
@@ -296,16 +368,23 @@ void WorldSound::tickSlot(Effect& slot) {
 
   if(slot.ambient) {
     slot.setOcclusion(1.f);
-    } else {
-    auto  dyn  = owner.physic();
-    auto  head = plPos;
-    auto  pos  = slot.pos;
-    float occ  = 1;
-
-    if((pos-head).quadLength()<slot.maxDist*slot.maxDist)
-      occ = dyn->soundOclusion(head, pos);
-    slot.setOcclusion(std::max(0.f,1.f-occ));
     }
+  else if((slot.pos-plPos).quadLength()<slot.maxDist*slot.maxDist) {
+    // actual value is resolved by applyOcclusion
+    Occlusion occ;
+    occ.eff = pslot;
+    occlusion.emplace_back(std::move(occ));
+    }
+  else {
+    slot.setOcclusion(0.f);
+    }
+  }
+
+void WorldSound::applyOcclusion() {
+  std::lock_guard<std::mutex> guard(sync);
+  for(auto& i:occlusion)
+    i.eff->setOcclusion(std::max(0.f,1.f-i.occ));
+  occlusion.clear();
   }
 
 void WorldSound::initSlot(WorldSound::Effect& slot) {
@@ -332,7 +411,7 @@ bool WorldSound::setMusic(std::string_view zone, GameMusic::Tags tags) {
   }
 
 bool WorldSound::isInListenerRange(const Tempest::Vec3& pos, float sndRgn) const {
-  float dist = sndRgn+800;
+  float dist = sndRgn+listenerPad;
   return (pos-plPos).quadLength()<dist*dist;
   }
 
@@ -59,10 +59,24 @@ class WorldSound final {
 
     using PEffect = std::shared_ptr<Effect>;
 
+    struct Occlusion {
+      PEffect eff;
+      float   occ = 0;
+      };
+
+    void    tickWorldEff();
     void    tickSoundZone(Npc& player);
     void    tickSlot(std::vector<PEffect>& eff);
-    void    tickSlot(Effect& slot);
+    void    tickSlot(const PEffect& slot);
     void    initSlot(Effect& slot);
+    void    applyOcclusion();
+
+    void    tickWorldEff(WSound& eff);
+    void    buildWorldEffIndex();
+
+    static int32_t  gridCell(float v);
+    static uint64_t gridKey(int32_t x, int32_t z);
+    static uint64_t gridKey(float x, float z);
     bool    setMusic(std::string_view zone, GameMusic::Tags tags);
 
     Sound   implAddSound(const SoundFx& s, const Tempest::Vec3& pos, float rangeMax);
@@ -85,9 +99,18 @@ class WorldSound final {
     std::vector<PEffect>                    effect3d; // snd_play3d
     std::vector<WSound>                     worldEff;
 
+    // worldEff, binned into 2d grid by listener range
+    std::vector<std::pair<uint64_t,uint32_t>> worldEffIndex;
+    std::vector<uint32_t>                   worldEffGlobal;
+    bool                                    worldEffIndexDurty = false;
+
+    std::vector<Occlusion>                  occlusion;
+
     std::mutex                              sync;
 
     static const float maxDist;
+    static const float listenerPad;
+    static const float gridSize;
 
   friend class Sound;
   };
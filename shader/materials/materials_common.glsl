@@ -190,16 +190,22 @@ Instance pullInstance(uint i) {
   ret.mat[3][2] = uintBitsToFloat(instanceMem[i+11]);
   ret.fatness   = uintBitsToFloat(instanceMem[i+12]);
   ret.animPtr   = instanceMem[i+13];
+  ret.wind      = uintBitsToFloat(instanceMem[i+14]);
+  if(ret.wind!=0)
+    ret.mat = windShear(ret.mat, ret.wind, scene.windDir, scene.windPhase);
   return ret;
   }
 
 MorphDesc pullMorphDesc(uint i) {
-  i *= 4;
+  i *= 8;
   MorphDesc ret;
-  ret.indexOffset         = instanceMem[i+0];
-  ret.sample0             = instanceMem[i+1];
-  ret.sample1             = instanceMem[i+2];
-  ret.alpha16_intensity16 = instanceMem[i+3];
+  ret.indexOffset     = instanceMem[i+0];
+  ret.samplesPerFrame = instanceMem[i+1];
+  ret.tickPerFrame    = instanceMem[i+2];
+  ret.numFrames       = instanceMem[i+3];
+  ret.timeStart       = instanceMem[i+4];
+  ret.timeUntil       = instanceMem[i+5];
+  ret.intensity       = uintBitsToFloat(instanceMem[i+6]);
   return ret;
   }
 
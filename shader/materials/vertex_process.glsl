@@ -68,10 +68,10 @@ vec3 morphOffset(uint bucketId, uint animPtr, uint vertexIndex) {
   const         uint i = 0;
 #endif
   MorphDesc md        = pullMorphDesc(animPtr);
-  vec2      ai        = unpackUnorm2x16(md.alpha16_intensity16);
-  float     alpha     = ai.x;
-  float     intensity = ai.y;
-  if(intensity<=0)
+  uint      f0        = 0;
+  uint      f1        = 0;
+  float     alpha     = 0;
+  if(!morphSample(md, scene.tickCount32, f0, f1, alpha))
     return vec3(0);
 
   uint  vId   = vertexIndex + md.indexOffset;
@@ -79,12 +79,10 @@ vec3 morphOffset(uint bucketId, uint animPtr, uint vertexIndex) {
   if(index<0)
     return vec3(0);
 
-  uint  f0 = md.sample0;
-  uint  f1 = md.sample1;
   vec3  a  = morph[i].samples[f0 + index].xyz;
   vec3  b  = morph[i].samples[f1 + index].xyz;
 
-  return mix(a,b,alpha) * intensity;
+  return mix(a,b,alpha) * md.intensity;
   }
 #endif
 
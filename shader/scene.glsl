@@ -38,6 +38,8 @@ struct SceneDesc {
   ivec2 screenRes;
   vec4  cloudsDir;
   float probeGridBias;
+  float windPhase;
+  vec2  windDir;
   };
 
 struct LightSource {
@@ -49,16 +51,20 @@ struct LightSource {
 
 struct MorphDesc {
   uint  indexOffset;
-  uint  sample0;
-  uint  sample1;
-  uint  alpha16_intensity16;
+  uint  samplesPerFrame;
+  uint  tickPerFrame;
+  uint  numFrames;
+  uint  timeStart;
+  uint  timeUntil;
+  float intensity;
+  uint  padd0;
   };
 
 struct Instance {
   mat4x3 mat;
   float  fatness;
   uint   animPtr;
-  uint   padd0;
+  float  wind;
   uint   padd1;
   };
 
@@ -93,4 +99,25 @@ struct Bucket {
   uint  flags;
   };
 
+mat4x3 windShear(mat4x3 mat, float wind, vec2 windDir, float windPhase) {
+  const float shift = mat[3].x*windDir.x + mat[3].z*windDir.y;
+  const float a     = wind * cos(windPhase + shift*0.0001);
+  mat[1].x += windDir.x*a;
+  mat[1].z += windDir.y*a;
+  return mat;
+  }
+
+bool morphSample(const MorphDesc md, uint tickCount, out uint sample0, out uint sample1, out float alpha) {
+  if(md.intensity<=0)
+    return false;
+  if(md.timeUntil!=0xFFFFFFFF && int(md.timeUntil - tickCount)<0)
+    return false;
+  const uint time  = tickCount - md.timeStart;
+  const uint frame = time/md.tickPerFrame;
+  sample0 = ((frame+0)%md.numFrames)*md.samplesPerFrame;
+  sample1 = ((frame+1)%md.numFrames)*md.samplesPerFrame;
+  alpha   = float(time%md.tickPerFrame)/float(md.tickPerFrame);
+  return true;
+  }
+
 #endif
@@ -0,0 +1,177 @@
+#include <Tempest/Log>
+
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "graphics/instancepatch.h"
+#include "utils/string_frm.h"
+
+using namespace Tempest;
+
+// Patch builder of InstanceStorage, checked against plain list of dirty blocks.
+// Exit code is non-zero on first mismatch.
+
+namespace {
+
+bool fail(const char* what, uint32_t seed, size_t i) {
+  string_frm msg("instancepatch: ", what, " seed = ", seed, " at = ", i);
+  Log::e(msg.c_str());
+  return false;
+  }
+
+// marks blocks in both patch builder and reference; reference keeps pending uploads per block
+void mark(InstancePatch& p, std::vector<bool>& ref, size_t block) {
+  p.markBlock(block);
+  ref[block] = true;
+  }
+
+// one frame: build patches, check them against reference, clear uploaded blocks in reference
+bool frame(InstancePatch& p, std::vector<bool>& ref, uint32_t seed, bool& deferred) {
+  const size_t                     blockSz = InstancePatch::blockSz;
+  std::vector<InstancePatch::Path> patches;
+  const size_t                     payload = p.build(patches, deferred);
+
+  size_t src = 0, runs = 0, prevEnd = size_t(-1);
+  std::vector<bool> uploaded(ref.size(), false);
+  for(auto& i:patches) {
+    if(i.src!=src)
+      return fail("payload is not contiguous",seed,i.dst);
+    if(i.size==0 || i.size>InstancePatch::chunkSz || i.size%blockSz!=0 || i.dst%blockSz!=0)
+      return fail("bad patch size",seed,i.dst);
+    if(i.dst/blockSz+i.size/blockSz>ref.size())
+      return fail("patch out of range",seed,i.dst);
+    if(i.dst!=prevEnd)
+      runs++;
+    prevEnd = i.dst+i.size;
+    src    += i.size;
+    for(size_t b=i.dst/blockSz; b<prevEnd/blockSz; ++b) {
+      if(uploaded[b])
+        return fail("block uploaded twice",seed,b);
+      uploaded[b] = true;
+      }
+    }
+  if(src!=payload)
+    return fail("payload size",seed,payload);
+  // budget may be exceeded only by single run, that alone is bigger than budget
+  if(payload>InstancePatch::uploadBudget && runs>1)
+    return fail("upload budget",seed,payload);
+
+  // clean blocks are uploaded only as short gaps inside of a run
+  for(size_t b=0; b<ref.size(); ++b) {
+    if(!uploaded[b] || ref[b])
+      continue;
+    size_t l = b, r = b;
+    while(l>0 && !ref[l-1] && uploaded[l-1])
+      --l;
+    while(r+1<ref.size() && !ref[r+1] && uploaded[r+1])
+      ++r;
+    if(r-l+1>InstancePatch::mergeGap || l==0 || !uploaded[l-1] || r+1>=ref.size() || !uploaded[r+1])
+      return fail("clean block uploaded",seed,b);
+    }
+
+  for(size_t b=0; b<ref.size(); ++b) {
+    if(ref[b] && uploaded[b])
+      ref[b] = false;
+    if(ref[b] && !deferred)
+      return fail("dirty block is lost",seed,b);
+    if(ref[b]!=p.isDurty(b))
+      return fail("dirty bit after build",seed,b);
+    }
+  return true;
+  }
+
+bool directed() {
+  const uint32_t    seed = 0;
+  InstancePatch     p;
+  std::vector<bool> ref(64, false);
+  p.resize(ref.size()*InstancePatch::blockSz);
+
+  // 0 and 2 are merged over single clean block, 5 is separate, 40..47 are split in chunks
+  for(size_t b:{0, 2, 5, 10, 11, 12})
+    mark(p,ref,b);
+  for(size_t b=40; b<48; ++b)
+    mark(p,ref,b);
+
+  std::vector<InstancePatch::Path> patches;
+  InstancePatch copy = p;
+  bool deferred = false;
+  copy.build(patches,deferred);
+  const InstancePatch::Path expect[] = {
+    {0,    0,   192},
+    {320,  192, 64 },
+    {640,  256, 192},
+    {2560, 448, 256},
+    {2816, 704, 256},
+    };
+  if(patches.size()!=std::size(expect) || deferred)
+    return fail("directed: patch count",seed,patches.size());
+  for(size_t i=0; i<patches.size(); ++i)
+    if(patches[i].dst!=expect[i].dst || patches[i].src!=expect[i].src || patches[i].size!=expect[i].size)
+      return fail("directed: patch",seed,i);
+
+  if(!frame(p,ref,seed,deferred))
+    return false;
+
+  // every 3rd block is dirty: no merge, total exceeds budget - rest goes to next frames
+  const size_t count = 4*InstancePatch::uploadBudget/InstancePatch::blockSz;
+  ref.assign(count, false);
+  p.resize(count*InstancePatch::blockSz);
+  for(size_t b=0; b<count; b+=3)
+    mark(p,ref,b);
+
+  size_t frames = 0;
+  do {
+    if(!frame(p,ref,seed,deferred))
+      return false;
+    ++frames;
+    } while(deferred);
+  if(frames<2)
+    return fail("directed: upload is not deferred",seed,frames);
+  return true;
+  }
+
+bool randomFrames(uint32_t seed) {
+  std::mt19937      rnd(seed);
+  auto              rand = [&rnd](size_t n) { return size_t(rnd()%n); };
+  InstancePatch     p;
+  std::vector<bool> ref;
+
+  for(uint32_t f=0; f<32; ++f) {
+    // storage grows, as in InstanceStorage::alloc
+    if(ref.empty() || rand(8)==0) {
+      ref.resize(ref.size() + 1 + rand(16*1024), false);
+      p.resize(ref.size()*InstancePatch::blockSz);
+      }
+
+    // sparse bones, dense objects, occasionally everything
+    const size_t marks = rand(4)==0 ? ref.size() : rand(ref.size()/4+1);
+    size_t       at    = rand(ref.size());
+    for(size_t i=0; i<marks; ++i) {
+      mark(p,ref,at);
+      at = (at + 1 + (rand(2)==0 ? 0 : rand(4))) % ref.size();
+      }
+
+    bool deferred = false;
+    if(!frame(p,ref,seed,deferred))
+      return false;
+    }
+  return true;
+  }
+
+}
+
+int main() {
+  if(!directed())
+    return 1;
+
+  const uint32_t seeds = 32;
+  for(uint32_t seed=0; seed<seeds; ++seed) {
+    if(!randomFrames(seed))
+      return 1;
+    }
+
+  string_frm msg("instancepatch: directed case and ", seeds, " random sequences match reference");
+  Log::i(msg.c_str());
+  return 0;
+  }
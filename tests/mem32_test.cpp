@@ -0,0 +1,290 @@
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "game/compatibility/mem32.h"
+#include "utils/string_frm.h"
+#include "mem32reference.h"
+
+using namespace Tempest;
+
+// Differential test of Mem32 (page table) against Mem32Reference (original region list).
+// Exit code is non-zero on first divergence.
+
+namespace {
+
+struct Allocation {
+  Mem32::ptr32_t a     = 0; // Mem32
+  uint32_t       b     = 0; // reference
+  uint32_t       size  = 0;
+  bool           fixed = false;
+  };
+
+// fixed-address blocks are tested away from initial dynamic allocations
+const uint32_t FixedBase  = 0x70000000;
+const uint32_t FixedPages = 16;
+const uint32_t PageSize   = 4096;
+
+bool overlapsPages(uint32_t at, uint32_t size, uint32_t block, uint32_t blockSize) {
+  const uint64_t b = block & ~(PageSize-1);
+  const uint64_t e = ((uint64_t(block)+std::max(blockSize,1u)+PageSize-1)/PageSize)*PageSize;
+  return at<e && b<uint64_t(at)+size;
+  }
+
+bool fail(const char* what, uint32_t seed, uint32_t i) {
+  string_frm msg("mem32: divergence from reference: ", what, " seed = ", seed, " iteration = ", i);
+  Log::e(msg.c_str());
+  return false;
+  }
+
+bool randomOps(uint32_t seed, uint32_t iterations) {
+  // host memory for pinned blocks must outlive both allocators
+  std::list<std::vector<uint8_t>> host;
+  Mem32                           mem;
+  Mem32Reference                  ref;
+  std::vector<Allocation>         live;
+  std::mt19937                    rnd(seed);
+
+  auto rand = [&rnd](uint32_t n) { return uint32_t(rnd()%n); };
+  auto size = [&rand]() {
+    // mostly slab-sized, sometimes multi-page
+    return rand(8)==0 ? 2049 + rand(3*4096) : 1 + rand(2048);
+    };
+  // placement of dynamic blocks differs by design, and Mem32 never shares a page between dynamic and fixed blocks:
+  // result of a fixed request, that touches pages of dynamic memory is not comparable
+  auto hitsDynamic = [&](uint32_t at, uint32_t sz) {
+    for(auto& x:live)
+      if(!x.fixed && (overlapsPages(at,sz,x.a,x.size) || overlapsPages(at,sz,x.b,x.size)))
+        return true;
+    return false;
+    };
+  auto same = [&](const Allocation& x) {
+    auto pa = mem.deref(x.a,x.size);
+    auto pb = ref.deref(x.b,x.size);
+    return pa!=nullptr && pb!=nullptr && std::memcmp(pa,pb,x.size)==0;
+    };
+
+  for(uint32_t i=0; i<iterations; ++i) {
+    switch(rand(10)) {
+      case 0:
+      case 1: {
+        Allocation x;
+        x.size = size();
+        x.a    = mem.alloc(x.size);
+        x.b    = ref.alloc(x.size);
+        if(x.a==0 || x.b==0)
+          return fail("alloc",seed,i);
+        live.push_back(x);
+        break;
+        }
+      case 2: {
+        if(rand(16)!=0)
+          break;
+        auto& h = host.emplace_back(1 + rand(64), uint8_t(rand(256)));
+        Allocation x;
+        x.size = uint32_t(h.size());
+        x.a    = mem.pin(h.data(),x.size);
+        x.b    = ref.pin(h.data(),x.size);
+        if(x.a==0 || x.b==0)
+          return fail("pin",seed,i);
+        if(mem.deref(x.a,x.size)!=h.data())
+          return fail("pin deref",seed,i);
+        live.push_back(x);
+        break;
+        }
+      case 3: {
+        if(live.empty())
+          break;
+        const uint32_t id = rand(uint32_t(live.size()));
+        mem.free(live[id].a);
+        ref.free(live[id].b);
+        live[id] = live.back();
+        live.pop_back();
+        break;
+        }
+      case 4: {
+        if(live.empty())
+          break;
+        auto& x = live[rand(uint32_t(live.size()))];
+        if(x.fixed)
+          break;
+        const uint32_t sz = size();
+        const auto     a  = mem.realloc(x.a,sz);
+        const auto     b  = ref.realloc(x.b,sz);
+        if((a==0) != (b==0))
+          return fail("realloc",seed,i);
+        if(a==0)
+          break; // pinned memory, rejected by both
+        x.a    = a;
+        x.b    = b;
+        x.size = sz;
+        break;
+        }
+      case 5: {
+        if(live.empty())
+          break;
+        auto& x = live[rand(uint32_t(live.size()))];
+        if(x.size<4)
+          break;
+        const uint32_t off = rand(x.size-3);
+        const int32_t  v   = int32_t(rnd());
+        mem.writeInt(x.a+off,v);
+        ref.writeInt(x.b+off,v);
+        break;
+        }
+      case 6: {
+        if(live.empty())
+          break;
+        auto& x = live[rand(uint32_t(live.size()))];
+        if(x.size<4)
+          break;
+        const uint32_t off = rand(x.size-3);
+        if(mem.readInt(x.a+off)!=ref.readInt(x.b+off))
+          return fail("readInt",seed,i);
+        break;
+        }
+      case 7: {
+        if(live.empty())
+          break;
+        auto& s = live[rand(uint32_t(live.size()))];
+        auto& d = live[rand(uint32_t(live.size()))];
+        const uint32_t sOff = rand(s.size);
+        const uint32_t dOff = rand(d.size);
+        const uint32_t sz   = rand(std::min(s.size-sOff,d.size-dOff)+1);
+        mem.copyBytes(s.a+sOff,d.a+dOff,sz);
+        ref.copyBytes(s.b+sOff,d.b+dOff,sz);
+        break;
+        }
+      case 8:
+      case 9: {
+        // fixed address, may share pages with other fixed blocks, or collide with them
+        Allocation x;
+        x.fixed = true;
+        x.size  = 1 + rand(rand(4)==0 ? 3*PageSize : 256);
+        const uint32_t at = FixedBase + rand(FixedPages*PageSize);
+        if(hitsDynamic(at,x.size))
+          break;
+        if(rand(2)==0) {
+          auto& h = host.emplace_back(x.size, uint8_t(rand(256)));
+          x.a = mem.pin(h.data(),at,x.size);
+          x.b = ref.pin(h.data(),at,x.size);
+          } else {
+          x.a = mem.alloc(at,x.size);
+          x.b = ref.alloc(at,x.size);
+          }
+        if(x.a!=x.b || (x.a!=0 && x.a!=at))
+          return fail("fixed address pin/alloc",seed,i);
+        if(x.a!=0)
+          live.push_back(x);
+        break;
+        }
+      }
+    }
+
+  for(auto& x:live)
+    if(!same(x))
+      return fail("content",seed,iterations);
+  return true;
+  }
+
+bool fixedAddress() {
+  const uint32_t seed = 0;
+  // same layout, as built-in Ikarus symbols
+  uint32_t versionHint = 504628679, oGame = 0, gameMan = 0;
+  uint8_t  zTimer[28]  = {};
+
+  Mem32          mem;
+  Mem32Reference ref;
+  struct Pin {
+    void*    ptr;
+    uint32_t address;
+    uint32_t size;
+    };
+  const Pin pins[] = {
+    {&versionHint, 0x401000, 4},
+    {&oGame,       0xAB0884, 4},
+    {&gameMan,     0x8C2958, 4},
+    {zTimer,       0x99B3D4, sizeof(zTimer)},
+    };
+  for(auto& p:pins) {
+    if(mem.pin(p.ptr,p.address,p.size)!=p.address || ref.pin(p.ptr,p.address,p.size)!=p.address)
+      return fail("pin at fixed address",seed,p.address);
+    if(mem.deref(p.address,p.size)!=p.ptr || mem.readInt(p.address)!=ref.readInt(p.address))
+      return fail("pinned deref",seed,p.address);
+    }
+
+  // second block on the same page: shared page
+  const uint32_t page = 0xAB0000;
+  if(mem.alloc(page+0x100,64)!=page+0x100 || ref.alloc(page+0x100,64)!=page+0x100)
+    return fail("fixed alloc on shared page",seed,0);
+  // overlaps pinned oGame pointer
+  if(mem.alloc(0xAB0880,8)!=0 || ref.alloc(0xAB0880,8)!=0)
+    return fail("overlapping fixed alloc",seed,0);
+  // crosses page boundary, shares first page with previous blocks
+  const uint32_t span = page+0x900;
+  if(mem.alloc(span,2*4096)!=span || ref.alloc(span,2*4096)!=span)
+    return fail("fixed alloc across pages",seed,0);
+  mem.writeInt(span+4096,42);
+  ref.writeInt(span+4096,42);
+  if(mem.readInt(span+4096)!=42 || ref.readInt(span+4096)!=42)
+    return fail("write to multi-page fixed block",seed,0);
+
+  // dynamic allocations must not land inside pages taken by fixed blocks
+  std::vector<Mem32::ptr32_t> dyn;
+  for(uint32_t i=0; i<4096; ++i) {
+    const uint32_t sz = (i%4==0) ? 5000 : 32;
+    auto a = mem.alloc(sz);
+    if(a==0)
+      return fail("dynamic alloc",seed,i);
+    for(auto& p:pins) {
+      const uint32_t pb = p.address & ~0xFFFu;
+      if(a<pb+4096 && pb<a+sz)
+        return fail("dynamic alloc inside fixed page",seed,i);
+      }
+    if(a<span+2*4096 && page<a+sz)
+      return fail("dynamic alloc inside fixed page",seed,i);
+    dyn.push_back(a);
+    }
+  for(auto a:dyn)
+    mem.free(a);
+
+  // free one block of shared page: neighbours stay reachable
+  mem.free(page+0x100);
+  ref.free(page+0x100);
+  if(mem.deref(0xAB0884,4)!=&oGame || mem.readInt(span+4096)!=42)
+    return fail("shared page after free",seed,0);
+  if(mem.alloc(page+0x100,16)!=page+0x100 || ref.alloc(page+0x100,16)!=page+0x100)
+    return fail("reuse of freed fixed range",seed,0);
+
+  // release everything on the page: whole range is available again
+  for(auto a:{page+0x100, 0xAB0884u, span}) {
+    mem.free(a);
+    ref.free(a);
+    }
+  if(mem.alloc(page,3*4096)!=page || ref.alloc(page,3*4096)!=page)
+    return fail("fixed alloc after release",seed,0);
+  if(mem.readInt(page+4096)!=0 || ref.readInt(page+4096)!=0)
+    return fail("fresh fixed block is not zeroed",seed,0);
+  return true;
+  }
+
+}
+
+int main() {
+  if(!fixedAddress())
+    return 1;
+
+  const uint32_t seeds = 64;
+  for(uint32_t seed=0; seed<seeds; ++seed) {
+    if(!randomOps(seed,4096))
+      return 1;
+    }
+
+  string_frm msg("mem32: ", seeds, " random sequences and fixed address cases match reference");
+  Log::i(msg.c_str());
+  return 0;
+  }
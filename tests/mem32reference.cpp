@@ -0,0 +1,325 @@
+#include "mem32reference.h"
+
+#include <Tempest/Log>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cstddef>
+
+using namespace Tempest;
+
+Mem32Reference::Mem32Reference() {
+  region.emplace_back(Region(0x1000,0x80000000));
+  }
+
+Mem32Reference::~Mem32Reference() {
+  for(auto& rgn:region) {
+    if(rgn.status==S_Allocated && rgn.real!=nullptr) {
+      std::free(rgn.real);
+      rgn.real = nullptr;
+      }
+    }
+  }
+
+Mem32Reference::ptr32_t Mem32Reference::pin(void* mem, ptr32_t address, uint32_t size, const char* comment) {
+  if(auto rgn = implAllocAt(address,size)) {
+    rgn->size    = size;
+    rgn->real    = mem;
+    rgn->status  = S_Pin;
+    rgn->comment = comment;
+    return address;
+    }
+  return 0;
+  }
+
+Mem32Reference::ptr32_t Mem32Reference::pin(void* mem, uint32_t size, const char* comment) {
+  if(auto rgn = implAlloc(size)) {
+    rgn->size    = size;
+    rgn->real    = mem;
+    rgn->status  = S_Pin;
+    rgn->comment = comment;
+    return rgn->address;
+    }
+  return 0;
+  }
+
+Mem32Reference::ptr32_t Mem32Reference::alloc(ptr32_t address, uint32_t size, const char* comment) {
+  if(address==0)
+    return alloc(size,comment);
+  if(auto rgn = implAllocAt(address,size)) {
+    rgn->real = std::calloc(std::max(size,1u),1);
+    if(rgn->real==nullptr) {
+      compactage();
+      return 0;
+      }
+    rgn->size    = size;
+    rgn->status  = S_Allocated;
+    rgn->comment = comment;
+    return address;
+    }
+  return 0;
+  }
+
+Mem32Reference::ptr32_t Mem32Reference::alloc(uint32_t size, const char* comment) {
+  if(auto rgn = implAlloc(std::max(size,1u))) {
+    rgn->real = std::calloc(rgn->size,1);
+    if(rgn->real==nullptr) {
+      compactage();
+      return 0;
+      }
+    rgn->status  = S_Allocated;
+    rgn->comment = comment;
+    return rgn->address;
+    }
+  return 0;
+  }
+
+void Mem32Reference::free(ptr32_t address) {
+  if(address==0)
+    return;
+  for(size_t i=0; i<region.size(); ++i) {
+    if(region[i].address!=address || region[i].status==S_Unused)
+      continue;
+    if(region[i].status==S_Allocated)
+      std::free(region[i].real);
+    region[i].real   = nullptr;
+    region[i].status = S_Unused;
+    compactage();
+    return;
+    }
+  Log::e("mem_free: heap block wan't allocated by script: ", reinterpret_cast<void*>(uint64_t(address)));
+  }
+
+void* Mem32Reference::deref(ptr32_t address, uint32_t size) {
+  auto rgn = translate(address);
+  if(rgn==nullptr) {
+    Log::e("deref: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
+    return nullptr;
+    }
+  if(uint64_t(rgn->address)+rgn->size < uint64_t(address)+size) {
+    Log::e("deref: memmory block is too small: ", reinterpret_cast<void*>(uint64_t(address)), " ", size);
+    return nullptr;
+    }
+  address -= rgn->address;
+  return reinterpret_cast<uint8_t*>(rgn->real)+address;
+  }
+
+void Mem32Reference::compactage() {
+  for(size_t i=0; i+1<region.size(); ) {
+    auto& a = region[i+0];
+    auto& b = region[i+1];
+    if(a.status==S_Unused && a.status==b.status && a.address+a.size==b.address) {
+      a.size += b.size;
+      b.size = 0;
+      region.erase(region.begin()+ptrdiff_t(i+1));
+      } else {
+      ++i;
+      }
+    }
+  }
+
+void Mem32Reference::writeInt(ptr32_t address, int32_t v) {
+  auto rgn = translate(address);
+  if(rgn==nullptr || rgn->address+rgn->size-address<4) {
+    Log::e("mem_writeint: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
+    return;
+    }
+  address -= rgn->address;
+  auto ptr = reinterpret_cast<uint8_t*>(rgn->real)+address;
+  std::memcpy(ptr,&v,4);
+  }
+
+int32_t Mem32Reference::readInt(ptr32_t address) {
+  auto rgn = translate(address);
+  if(rgn==nullptr || rgn->address+rgn->size-address<4) {
+    Log::e("mem_readint:  address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
+    return 0;
+    }
+  address -= rgn->address;
+  auto ptr = reinterpret_cast<uint8_t*>(rgn->real)+address;
+  int32_t ret = 0;
+  std::memcpy(&ret,ptr,4);
+  return ret;
+  }
+
+void Mem32Reference::copyBytes(ptr32_t psrc, ptr32_t pdst, uint32_t size) {
+  auto src = translate(psrc);
+  auto dst = translate(pdst);
+  if(src==nullptr) {
+    Log::e("mem_copybytes: address translation failure: ", reinterpret_cast<void*>(uint64_t(psrc)));
+    return;
+    }
+  if(dst==nullptr) {
+    Log::e("mem_copybytes: address translation failure: ", reinterpret_cast<void*>(uint64_t(pdst)));
+    return;
+    }
+
+  size_t sOff = psrc - src->address;
+  size_t dOff = pdst - dst->address;
+  size_t sz   = size;
+  if(src->size<sOff+size) {
+    Log::e("mem_copybytes: copy-size exceed source block size: ", size);
+    sz = std::min(src->size-sOff,sz);
+    }
+  if(dst->size<dOff+size) {
+    Log::e("mem_copybytes: copy-size exceed destination block size: ", size);
+    sz = std::min(dst->size-dOff,sz);
+    }
+  std::memmove(reinterpret_cast<uint8_t*>(dst->real)+dOff,
+               reinterpret_cast<uint8_t*>(src->real)+sOff,
+               sz);
+  }
+
+Mem32Reference::Region* Mem32Reference::implAlloc(uint32_t size) {
+  size = ((size+memAlign-1)/memAlign)*memAlign;
+
+  for(size_t i=0; i<region.size(); ++i) {
+    if(region[i].status!=S_Unused || region[i].size<size)
+      continue;
+    if(size!=region[i].size) {
+      auto p2 = region[i];
+      p2.address+=size;
+      p2.size   -=size;
+      region.insert(region.begin()+ptrdiff_t(i+1),p2);
+      }
+    region[i].size = size;
+    return &region[i];
+    }
+
+  return nullptr;
+  }
+
+Mem32Reference::ptr32_t Mem32Reference::realloc(ptr32_t address, uint32_t size) {
+  size = ((std::max(size,1u)+memAlign-1)/memAlign)*memAlign;
+  if(address==0)
+    return alloc(size);
+  if(implRealloc(address,size))
+    return address;
+
+  auto src = translate(address);
+  if(src==nullptr || src->address!=address) {
+    Log::e("realloc: address translation failure: ", reinterpret_cast<void*>(uint64_t(address)));
+    return alloc(size);
+    }
+  if(src->status==S_Pin) {
+    Log::e("realloc: unable to reallocate pinned memory: ", reinterpret_cast<void*>(uint64_t(address)));
+    return 0;
+    }
+
+  const uint32_t prevSize = src->size;
+  auto real = std::realloc(src->real, size);
+  if(real==nullptr)
+    return 0;
+  if(size>prevSize)
+    std::memset(reinterpret_cast<uint8_t*>(real)+prevSize, 0, size-prevSize);
+  src->real = real;
+
+  auto next = implAlloc(size);
+  if(next==nullptr)
+    return 0;
+  // implAlloc may insert regions
+  src = translate(address);
+
+  next->status  = S_Allocated;
+  next->real    = src->real;
+  next->comment = src->comment;
+
+  src->real     = nullptr;
+  src->status   = S_Unused;
+
+  auto ret = next->address;
+  compactage();
+  return ret;
+  }
+
+Mem32Reference::Region* Mem32Reference::implAllocAt(ptr32_t address, uint32_t size) {
+  for(size_t i=0; i<region.size(); ++i) {
+    auto& rgn = region[i];
+
+    if(address!=0) {
+      if(!(rgn.address<=address && address+size<=rgn.address+rgn.size))
+        continue;
+      } else {
+      if(rgn.size<size)
+        continue;
+      }
+
+    if(rgn.status!=S_Unused) {
+      Log::e("failed to pin a ",size," bytes of memory: block is in use");
+      return 0;
+      }
+
+    if(address==0)
+      address = region[i].address;
+
+    if(region[i].address<address) {
+      uint32_t off = (address-region[i].address);
+      auto p2 = region[i];
+      p2.address+=off;
+      p2.size   -=off;
+      region.insert(region.begin()+ptrdiff_t(i+1),p2);
+      region[i].size = off;
+      ++i;
+      }
+    if(size!=region[i].size) {
+      auto p2 = region[i];
+      p2.address+=size;
+      p2.size   -=size;
+      region.insert(region.begin()+ptrdiff_t(i+1),p2);
+      }
+
+    return &region[i];
+    }
+  return nullptr;
+  }
+
+bool Mem32Reference::implRealloc(ptr32_t address, uint32_t nsize) {
+  // NOTE: in place only
+  for(size_t i=0; i<region.size(); ++i) {
+    auto& rgn = region[i];
+    if(rgn.address!=address || rgn.status!=S_Allocated)
+      continue;
+
+    if(nsize==rgn.size)
+      return true;
+
+    if(nsize<rgn.size) {
+      if(auto next = std::realloc(rgn.real, nsize))
+        rgn.real = next;
+      Region frgn(address+nsize, rgn.size-nsize);
+      rgn.size = nsize;
+      region.insert(region.begin() + intptr_t(i + 1), frgn);
+      compactage();
+      return true;
+      }
+
+    if(i+1==region.size())
+      return false; // can't expand
+
+    auto& rgn2 = region[i+1];
+    if(rgn2.status==S_Unused && rgn.size + rgn2.size>=nsize) {
+      auto next = std::realloc(rgn.real, nsize);
+      if(next==nullptr)
+        return false;
+      std::memset(reinterpret_cast<uint8_t*>(next)+rgn.size, 0, nsize-rgn.size);
+      rgn2.address += (nsize-rgn.size);
+      rgn2.size    -= (nsize-rgn.size);
+      rgn.real      = next;
+      rgn.size      = nsize;
+      if(rgn2.size==0)
+        region.erase(region.begin()+ptrdiff_t(i+1));
+      return true;
+      }
+
+    return false;
+    }
+  return false;
+  }
+
+Mem32Reference::Region* Mem32Reference::translate(ptr32_t address) {
+  for(auto& rgn:region) {
+    if(rgn.address<=address && address<uint64_t(rgn.address)+rgn.size && rgn.status!=S_Unused)
+      return &rgn;
+    }
+  return nullptr;
+  }
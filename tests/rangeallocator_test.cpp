@@ -0,0 +1,256 @@
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "utils/rangeallocator.h"
+#include "utils/string_frm.h"
+
+using namespace Tempest;
+
+// Fuzz test of RangeAllocator against plain per-unit occupancy map, followed by benchmark
+// against linear free-list, that InstanceStorage used before.
+// Exit code is non-zero on first mismatch.
+
+namespace {
+
+struct Allocation {
+  size_t begin = 0;
+  size_t size  = 0;
+  };
+
+bool fail(const char* what, uint32_t seed, size_t i) {
+  string_frm msg("rangeallocator: ", what, " seed = ", seed, " iteration = ", i);
+  Log::e(msg.c_str());
+  return false;
+  }
+
+class Reference {
+  public:
+    void grow(size_t sz) { used.resize(used.size()+sz, false); freeSz += sz; }
+
+    bool isFree(size_t begin, size_t size) const {
+      if(begin+size>used.size())
+        return false;
+      for(size_t i=begin; i<begin+size; ++i)
+        if(used[i])
+          return false;
+      return true;
+      }
+    void mark(size_t begin, size_t size, bool u) {
+      for(size_t i=begin; i<begin+size; ++i)
+        used[i] = u;
+      if(u)
+        freeSz -= size; else
+        freeSz += size;
+      }
+    size_t maxRun() const {
+      size_t ret = 0, run = 0;
+      for(bool u:used) {
+        run = u ? 0 : run+1;
+        ret = std::max(ret,run);
+        }
+      return ret;
+      }
+    size_t capacity() const { return used.size(); }
+    size_t freeSize() const { return freeSz; }
+
+  private:
+    std::vector<bool> used;
+    size_t            freeSz = 0;
+  };
+
+bool fuzz(uint32_t seed, uint32_t iterations) {
+  std::mt19937            rnd(seed);
+  auto                    rand = [&rnd](size_t n) { return size_t(rnd()%n); };
+  RangeAllocator          mem;
+  Reference               ref;
+  std::vector<Allocation> live;
+
+  auto size = [&]() -> size_t {
+    switch(rand(4)) {
+      case 0:  return 1 + rand(15);                       // small classes
+      case 1:  return size_t(64) << rand(7);              // InstanceStorage: pot, 64-aligned
+      case 2:  return 1 + rand(4096);
+      default: return 1 + rand(16*1024);
+      }
+    };
+  auto grow = [&](size_t sz) {
+    // storage is owned by caller: on failure it grows and hands new tail to allocator
+    const size_t at = ref.capacity();
+    ref.grow(sz);
+    mem.free(at,sz);
+    };
+
+  grow(64*1024);
+  for(uint32_t i=0; i<iterations; ++i) {
+    switch(rand(8)) {
+      case 0:
+      case 1:
+      case 2: {
+        const size_t sz = size();
+        size_t       at = mem.alloc(sz);
+        if(at==RangeAllocator::npos) {
+          if(ref.maxRun()>=sz)
+            return fail("alloc failed, while free range exists",seed,i);
+          grow(sz + rand(sz+1));
+          at = mem.alloc(sz);
+          if(at==RangeAllocator::npos)
+            return fail("alloc failed after grow",seed,i);
+          }
+        if(!ref.isFree(at,sz))
+          return fail("alloc returned used range",seed,i);
+        ref.mark(at,sz,true);
+        live.push_back({at,sz});
+        break;
+        }
+      case 3: {
+        const size_t sz = size();
+        const size_t at = rand(ref.capacity());
+        const bool   ok = mem.allocAt(at,sz);
+        if(ok!=ref.isFree(at,sz))
+          return fail("allocAt",seed,i);
+        if(ok) {
+          ref.mark(at,sz,true);
+          live.push_back({at,sz});
+          }
+        break;
+        }
+      case 4:
+      case 5:
+      case 6: {
+        if(live.empty())
+          break;
+        const size_t id = rand(live.size());
+        mem.free(live[id].begin,live[id].size);
+        ref.mark(live[id].begin,live[id].size,false);
+        live[id] = live.back();
+        live.pop_back();
+        break;
+        }
+      case 7: {
+        if(rand(256)!=0)
+          break;
+        // release everything: coalesced back into one range
+        for(auto& a:live) {
+          mem.free(a.begin,a.size);
+          ref.mark(a.begin,a.size,false);
+          }
+        live.clear();
+        if(mem.alloc(ref.capacity())!=0)
+          return fail("free ranges are not coalesced",seed,i);
+        mem.free(0,ref.capacity());
+        break;
+        }
+      }
+    if(mem.freeSize()!=ref.freeSize())
+      return fail("freeSize",seed,i);
+    }
+  return true;
+  }
+
+// InstanceStorage free-list before RangeAllocator: exact-size match, then best fit; merge with one neighbour
+class LinearFreeList {
+  public:
+    size_t alloc(size_t size) {
+      for(size_t i=0; i<rgn.size(); ++i) {
+        if(rgn[i].size==size) {
+          auto ret = rgn[i].begin;
+          rgn.erase(rgn.begin()+intptr_t(i));
+          return ret;
+          }
+        }
+      size_t retId = size_t(-1);
+      for(size_t i=0; i<rgn.size(); ++i) {
+        if(rgn[i].size>size && (retId==size_t(-1) || rgn[i].size<rgn[retId].size))
+          retId = i;
+        }
+      if(retId==size_t(-1))
+        return RangeAllocator::npos;
+      auto ret = rgn[retId].begin;
+      rgn[retId].begin += size;
+      rgn[retId].size  -= size;
+      return ret;
+      }
+
+    void free(size_t begin, size_t size) {
+      for(auto& i:rgn) {
+        if(i.begin+i.size==begin) {
+          i.size += size;
+          return;
+          }
+        if(begin+size==i.begin) {
+          i.begin -= size;
+          i.size  += size;
+          return;
+          }
+        }
+      Allocation r = {begin,size};
+      auto at = std::lower_bound(rgn.begin(),rgn.end(),r,[](const Allocation& l, const Allocation& r){
+        return l.begin<r.begin;
+        });
+      rgn.insert(at,r);
+      }
+
+  private:
+    std::vector<Allocation> rgn;
+  };
+
+// world transition: half of objects is despawned, then as many are spawned; storage grows by bump on failure
+template<class Alloc>
+void benchmark(const char* name, size_t liveCount, size_t rounds) {
+  std::mt19937            rnd(0);
+  auto                    rand = [&rnd](size_t n) { return size_t(rnd()%n); };
+  Alloc                   mem;
+  std::vector<Allocation> live;
+  size_t                  top = 0;
+
+  auto alloc = [&](size_t sz) {
+    auto at = mem.alloc(sz);
+    if(at==RangeAllocator::npos) {
+      at   = top;
+      top += sz;
+      }
+    live.push_back({at,sz});
+    };
+
+  for(size_t i=0; i<liveCount; ++i)
+    alloc(size_t(64) << rand(7));
+
+  const auto t0 = std::chrono::high_resolution_clock::now();
+  for(size_t r=0; r<rounds; ++r) {
+    for(size_t i=0; i<liveCount/2; ++i) {
+      const size_t id = rand(live.size());
+      mem.free(live[id].begin,live[id].size);
+      live[id] = live.back();
+      live.pop_back();
+      }
+    for(size_t i=0; i<liveCount/2; ++i)
+      alloc(size_t(64) << rand(7));
+    }
+  const auto t1 = std::chrono::high_resolution_clock::now();
+
+  const double ms = std::chrono::duration<double,std::milli>(t1-t0).count();
+  string_frm msg("rangeallocator: ", name, " live = ", liveCount, " transitions = ", rounds,
+                 " time = ", ms, " ms storage = ", top/1024, " KB");
+  Log::i(msg.c_str());
+  }
+}
+
+int main() {
+  const uint32_t seeds = 32;
+  for(uint32_t seed=0; seed<seeds; ++seed) {
+    if(!fuzz(seed,2048))
+      return 1;
+    }
+  string_frm msg("rangeallocator: ", seeds, " random sequences match reference");
+  Log::i(msg.c_str());
+
+  for(size_t live:{1000, 10000}) {
+    benchmark<RangeAllocator>("tlsf       ", live, 4);
+    benchmark<LinearFreeList>("linear list", live, 4);
+    }
+  return 0;
+  }